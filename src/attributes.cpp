@@ -29,6 +29,8 @@ tl::optional<AttrDesc> parse_attributes(std::string attr_src) {
         return AttrDesc{{}, AttrDesc::Kind::OpaqueBytes};
     } else if (toks[1] == "valuetype") {
         return AttrDesc{{}, AttrDesc::Kind::ValueType};
+    } else if (toks[1] == "batch") {
+        return AttrDesc{{}, AttrDesc::Kind::Batch};
     }
 
     fmt::print("Warning Could not parse attribute '{}'\n", attr_src);
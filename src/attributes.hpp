@@ -15,6 +15,7 @@ struct AttrDesc {
         OpaquePtr,
         OpaqueBytes,
         ValueType,
+        Batch,
     };
 
     std::string params;
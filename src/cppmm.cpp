@@ -26,6 +26,7 @@
 #include "match_decls.hpp"
 #include "method.hpp"
 #include "namespaces.hpp"
+#include "options.hpp"
 #include "param.hpp"
 #include "record.hpp"
 #include "type.hpp"
@@ -86,6 +87,72 @@ static cl::list<std::string>
 
 static cl::list<std::string> opt_includes("i", cl::desc("Extra includes for the project"));
 static cl::list<std::string> opt_libraries("l", cl::desc("Libraries to link against"));
+static cl::opt<bool> opt_pch(
+    "pch", cl::desc("Use precompiled headers in the generated project"));
+static cl::opt<bool> opt_lto(
+    "lto", cl::desc("Build the generated project with ThinLTO, mark the "
+                    "wrappers always_inline and add a <project>-lto "
+                    "interface target for callers"));
+static cl::opt<bool> opt_shared(
+    "shared", cl::desc("Generate a shared library that only exports the "
+                       "bound functions"));
+static cl::opt<bool> opt_owned_strings(
+    "owned-strings",
+    cl::desc("Return strings as cppmm_string handles and cppmm_string_views "
+             "rather than copying into a buffer"));
+static cl::opt<bool> opt_string_lengths(
+    "string-lengths",
+    cl::desc("Pass string and string_view parameters as a pointer and a "
+             "length"));
+
+static cl::opt<bool> opt_out_param_returns(
+    "out-param-returns",
+    cl::desc("Return opaquebytes and vector types through a pointer to "
+             "caller-provided storage"));
+
+static cl::opt<unsigned> opt_by_value_max_size(
+    "by-value-max-size",
+    cl::desc("Pass valuetype and opaquebytes records up to this many bytes by "
+             "value instead of by pointer when the function takes them by "
+             "const reference"),
+    cl::init(0));
+
+static cl::opt<bool> opt_c_attributes(
+    "c-attributes",
+    cl::desc("Annotate generated declarations with pure/const, nonnull, "
+             "nothrow and warn_unused_result attributes where they can be "
+             "derived from the C++ declaration"));
+
+static cl::opt<bool> opt_constant_values(
+    "constant-values",
+    cl::desc("Evaluate constexpr functions that take no parameters, and "
+             "static constexpr data members of bound records, and emit "
+             "their results as static const values in the headers"));
+
+static cl::opt<bool> opt_inline_accessors(
+    "inline-accessors",
+    cl::desc("Translate valuetype and opaquebytes methods that only compute "
+             "on fields and parameters into static inline C functions as "
+             "well"));
+
+static cl::opt<bool> opt_catch_exceptions(
+    "catch-exceptions",
+    cl::desc("Catch exceptions thrown by bound functions that are not "
+             "noexcept and report them through cppmm_error_code() instead of "
+             "unwinding into C. The generated container, shared_ptr and "
+             "field accessor helpers are not wrapped"));
+
+static cl::opt<bool> opt_field_accessors(
+    "field-accessors",
+    cl::desc("Generate getters and setters for the public fields of "
+             "opaquebytes and opaqueptr records, and _snapshot/_apply "
+             "functions that copy them all in one call"));
+
+static cl::opt<bool> opt_reflection(
+    "reflection",
+    cl::desc("Emit static const tables of the field names, offsets, sizes and "
+             "kinds of valuetype and opaquebytes records, and of the "
+             "enumerators of enums"));
 
 int main(int argc, const char** argv) {
     std::vector<std::string> project_includes = parse_project_includes(argc, argv);
@@ -130,6 +197,20 @@ int main(int argc, const char** argv) {
         project_libraries.push_back(l);
     }
 
+    cppmm::options.precompiled_headers = opt_pch;
+    cppmm::options.lto = opt_lto;
+    cppmm::options.shared = opt_shared;
+    cppmm::options.owned_strings = opt_owned_strings;
+    cppmm::options.string_lengths = opt_string_lengths;
+    cppmm::options.out_param_returns = opt_out_param_returns;
+    cppmm::options.by_value_max_size = opt_by_value_max_size;
+    cppmm::options.c_attributes = opt_c_attributes;
+    cppmm::options.constant_values = opt_constant_values;
+    cppmm::options.inline_accessors = opt_inline_accessors;
+    cppmm::options.catch_exceptions = opt_catch_exceptions;
+    cppmm::options.field_accessors = opt_field_accessors;
+    cppmm::options.reflection = opt_reflection;
+
     // fmt::print("source files: [{}]\n",
     //            ps::join(", ", OptionsParser.getSourcePathList()));
 
@@ -195,8 +276,8 @@ int main(int argc, const char** argv) {
 
     for (const auto& g : generators) {
         g->generate(output_dir, cppmm::ex_files, cppmm::files, cppmm::records,
-                    cppmm::enums, cppmm::vectors, project_includes,
-                    project_libraries);
+                    cppmm::enums, cppmm::vectors, cppmm::shared_ptrs,
+                    cppmm::maps, project_includes, project_libraries);
     }
 
     if (opt_warn_unbound) {
@@ -1,15 +1,26 @@
 #include "decls.hpp"
 #include "exports.hpp"
 #include "namespaces.hpp"
+#include "options.hpp"
 #include "vector.hpp"
 
 #include "pystring.h"
 
+#include <clang/AST/APValue.h>
 #include <clang/AST/DeclCXX.h>
+#include <clang/AST/DeclTemplate.h>
+#include <clang/AST/Expr.h>
+#include <clang/AST/RecordLayout.h>
+#include <clang/AST/Stmt.h>
 #include <clang/AST/Type.h>
+#include <clang/Basic/TargetInfo.h>
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+
 using namespace clang;
 
 namespace cppmm {
@@ -18,6 +29,11 @@ std::unordered_map<std::string, cppmm::File> files;
 std::unordered_map<std::string, cppmm::Record> records;
 std::unordered_map<std::string, cppmm::Enum> enums;
 std::unordered_map<std::string, cppmm::Vector> vectors;
+std::unordered_map<std::string, cppmm::SharedPtr> shared_ptrs;
+std::unordered_map<std::string, cppmm::FuncProto> func_protos;
+std::unordered_map<std::string, cppmm::Span> spans;
+std::unordered_map<std::string, cppmm::Map> maps;
+std::unordered_map<std::string, cppmm::SumType> sum_types;
 
 bool is_builtin(const QualType& qt) {
     return (qt->isBuiltinType() ||
@@ -33,14 +49,38 @@ std::string qualified_type_name(const cppmm::Type& type) {
     return cppmm::prefix_from_namespaces(type.namespaces, "::") + type.name;
 }
 
+// Can field be read and written from C by value through an accessor? Only
+// public, trivially copyable scalar fields and fields of valuetype or
+// opaquebytes records qualify, since the accessors copy their bytes
+bool is_accessor_field(const FieldDecl* field, const QualifiedType& qtype) {
+    if (field->getAccess() != AS_public || field->isBitField() ||
+        !field->getType().isTriviallyCopyableType(field->getASTContext()) ||
+        qtype.is_ptr || qtype.is_ref || qtype.is_uptr ||
+        !qtype.array_extents.empty()) {
+        return false;
+    }
+
+    if (const Record* record = qtype.type.var.cast_or_null<Record>()) {
+        return record->kind != RecordKind::OpaquePtr;
+    }
+    return qtype.type.var.is<Enum>() ||
+           (qtype.type.var.is<Builtin>() &&
+            qtype.type.name.find('*') == std::string::npos);
+}
+
+std::vector<ConstantMember>
+get_constant_members(const CXXRecordDecl* record);
+
 cppmm::Record* process_record(const CXXRecordDecl* record) {
     // fmt::print("process_record {}\n", record->getQualifiedNameAsString());
-    std::string cpp_name = record->getNameAsString();
+    std::string cpp_name;
+    std::string c_name;
+    cppmm::get_record_names(record, cpp_name, c_name);
     std::vector<std::string> namespaces =
         cppmm::get_namespaces(record->getParent());
 
     const auto c_qname =
-        cppmm::prefix_from_namespaces(namespaces, "_") + cpp_name;
+        cppmm::prefix_from_namespaces(namespaces, "_") + c_name;
     if (records.find(c_qname) != records.end()) {
         // already done this type, return
         return &records[c_qname];
@@ -54,6 +94,7 @@ cppmm::Record* process_record(const CXXRecordDecl* record) {
     }
 
     std::vector<cppmm::Param> fields;
+    std::vector<cppmm::Param> accessor_fields;
     for (const auto* field : record->fields()) {
         std::string field_name = field->getNameAsString();
         // fmt::print("    field: {}\n", field->getNameAsString());
@@ -61,6 +102,12 @@ cppmm::Record* process_record(const CXXRecordDecl* record) {
             process_param_type(field_name, field->getType());
         fields.push_back(field_param);
         // fmt::print("    {}\n", field_param);
+
+        if (options.field_accessors &&
+            it_ex_record->second.kind != RecordKind::ValueType &&
+            is_accessor_field(field, field_param.qtype)) {
+            accessor_fields.push_back(field_param);
+        }
     }
 
     // get size and alignment info
@@ -69,22 +116,55 @@ cppmm::Record* process_record(const CXXRecordDecl* record) {
     size_t size = ctx.getTypeSize(record->getTypeForDecl()) / 8;
     size_t alignment = ctx.getTypeAlign(record->getTypeForDecl()) / 8;
 
+    std::vector<cppmm::FieldLayout> field_layouts;
+    if (options.reflection) {
+        const ASTRecordLayout& layout = ctx.getASTRecordLayout(record);
+        for (const auto* field : record->fields()) {
+            field_layouts.push_back(cppmm::FieldLayout{
+                layout.getFieldOffset(field->getFieldIndex()) / 8,
+                (size_t)ctx.getTypeSizeInChars(field->getType()).getQuantity(),
+                field->isBitField()});
+        }
+    }
+
     // fmt::print("Processed record {} -> {} in {}\n", cpp_name, c_qname,
     //    it_ex_record->second.filename);
     auto rec = cppmm::Record{
         .cpp_name = cpp_name,
         .namespaces = namespaces,
-        .c_name = cpp_name,
+        .c_name = c_name,
         .kind = it_ex_record->second.kind,
         .filename = it_ex_record->second.filename,
         .fields = fields,
+        .accessor_fields = accessor_fields,
+        .field_layouts = field_layouts,
+        .constants = {},
         .methods = {},
         .size = size,
         .alignment = alignment,
+        .is_trivial = record->hasDefinition() && record->isTrivial(),
         .cpp_qname = cppmm::prefix_from_namespaces(namespaces, "::") + cpp_name,
         .c_qname = c_qname,
     };
 
+    if (rec.kind == cppmm::RecordKind::ValueType) {
+        // nested records are laid out inline, so they must have a C
+        // declaration with the right size themselves
+        for (const auto& field : rec.fields) {
+            if (!field.qtype.type.var.is<Record>() || field.qtype.is_ptr) {
+                continue;
+            }
+            const Record* field_record = field.qtype.type.var.cast<Record>();
+            if (field_record == nullptr ||
+                field_record->kind == cppmm::RecordKind::OpaquePtr) {
+                fmt::print("ERROR: {} is valuetype but field {} is not a "
+                           "valuetype or opaquebytes record\n",
+                           rec.c_qname, field.name);
+                return nullptr;
+            }
+        }
+    }
+
     if (rec.kind == cppmm::RecordKind::ValueType && !rec.is_pod()) {
         fmt::print("ERROR: {} is valuetype but not POD\n", rec.c_qname);
         return nullptr;
@@ -96,6 +176,11 @@ cppmm::Record* process_record(const CXXRecordDecl* record) {
     records[c_qname] = rec;
     // fmt::print("MATCHED: {}\n", cpp_name);
 
+    // only now, since the constants may be of the record's own type
+    if (options.constant_values) {
+        records[c_qname].constants = get_constant_members(record);
+    }
+
     return &records[c_qname];
 }
 
@@ -129,13 +214,26 @@ Enum* process_enum(const EnumDecl* enum_decl) {
             ecd->getNameAsString(), ecd->getInitVal().getLimitedValue()));
     }
 
+    std::string underlying_type = "int";
+    const QualType integer_type = enum_decl->getIntegerType();
+    if (!integer_type.isNull()) {
+        underlying_type = integer_type->getUnqualifiedDesugaredType()
+                              ->getAs<BuiltinType>()
+                              ->desugar()
+                              .getAsString();
+        if (underlying_type == "_Bool") {
+            underlying_type = "bool";
+        }
+    }
+
     enums[c_qname] = cppmm::Enum{.cpp_name = cpp_name,
                                  .namespaces = namespaces,
                                  .c_name = c_name,
                                  .filename = it_ex_enum->second.filename,
                                  .enumerators = enumerators,
                                  .cpp_qname = cpp_qname,
-                                 .c_qname = c_qname};
+                                 .c_qname = c_qname,
+                                 .underlying_type = underlying_type};
 
     // fmt::print("MATCHED: {}\n", cpp_name);
 
@@ -160,6 +258,299 @@ Vector* process_vector(const QualifiedType& element_type) {
     }
 }
 
+SharedPtr* process_shared_ptr(const QualifiedType& element_type) {
+    // shared_ptrs are stored by the c_qname of their element, like vectors,
+    // so that the generator can emit them next to the element's record
+    const std::string ename = element_type.type.get_c_qname();
+    auto it_sptr = shared_ptrs.find(ename);
+    if (it_sptr != shared_ptrs.end()) {
+        return &it_sptr->second;
+    } else {
+        auto p = shared_ptrs.insert(std::make_pair(
+            ename,
+            SharedPtr{element_type, fmt::format("{}_shared_ptr", ename)}));
+        return &p.first->second;
+    }
+}
+
+// qt is the callback type as it was spelled, so that we can reuse the name of
+// a typedef for it
+FuncProto* process_func_proto(const QualType& qt, const FunctionProtoType* fpt,
+                              bool is_std_function) {
+    QualifiedType return_type = process_qualified_type(fpt->getReturnType());
+    std::vector<QualifiedType> param_types;
+    for (const auto& param_type : fpt->getParamTypes()) {
+        param_types.push_back(process_qualified_type(param_type));
+    }
+
+    std::vector<std::string> cpp_params;
+    for (const auto& param_type : param_types) {
+        cpp_params.push_back(get_cpp_spelling(param_type));
+    }
+
+    std::string cpp_qname;
+    if (is_std_function) {
+        cpp_qname =
+            fmt::format("std::function<{}({})>", get_cpp_spelling(return_type),
+                        pystring::join(", ", cpp_params));
+    } else {
+        cpp_qname =
+            fmt::format("{} (*)({})", get_cpp_spelling(return_type),
+                        pystring::join(", ", cpp_params));
+    }
+
+    std::string c_qname;
+    if (const auto* tt = qt->getAs<TypedefType>()) {
+        const TypedefNameDecl* tdn = tt->getDecl();
+        c_qname = prefix_from_namespaces(get_namespaces(tdn->getDeclContext()),
+                                         "_") +
+                  tdn->getNameAsString();
+    } else {
+        // name it after the C signature, so that every use of the same
+        // signature shares the typedef
+        std::vector<std::string> parts = {is_std_function ? "cppmm_function"
+                                                          : "cppmm_fnptr",
+                                          return_type.create_c_declaration()};
+        for (const auto& param_type : param_types) {
+            parts.push_back(param_type.create_c_declaration());
+        }
+        c_qname = pystring::join("_", parts);
+        for (auto& c : c_qname) {
+            if (c == '*') {
+                c = 'p';
+            } else if (!isalnum(c)) {
+                c = '_';
+            }
+        }
+    }
+
+    for (const auto& param_type : param_types) {
+        if (param_type.type.var.is<Vector>() ||
+            param_type.type.var.is<SharedPtr>() ||
+            param_type.type.var.is<String>() || param_type.is_uptr ||
+            param_type.type.var.is<FuncProto>()) {
+            fmt::print("ERROR: callback {} has a parameter of type {} that "
+                       "cannot be passed to C\n",
+                       cpp_qname, get_cpp_spelling(param_type));
+            throw std::runtime_error("unhandled callback parameter type");
+        }
+    }
+
+    // a raw function pointer is handed to C++ as is, so its C and C++
+    // signatures have to be call-compatible. Records by value may be passed
+    // by invisible reference in C++, and enums may be narrower than the int
+    // C sees, so only std::function, which we wrap in a converting lambda,
+    // can take those
+    if (!is_std_function) {
+        std::vector<const QualifiedType*> signature_types = {&return_type};
+        for (const auto& param_type : param_types) {
+            signature_types.push_back(&param_type);
+        }
+        for (const auto* qtype : signature_types) {
+            if ((qtype->type.var.is<Record>() ||
+                 qtype->type.var.is<Enum>()) &&
+                !qtype->is_ptr && !qtype->is_ref) {
+                fmt::print("ERROR: function pointer {} takes or returns {} "
+                           "by value, which C can't call through the C++ "
+                           "signature\n",
+                           cpp_qname, get_cpp_spelling(*qtype));
+                throw std::runtime_error("unhandled callback signature");
+            }
+        }
+    }
+
+    auto it_fp = func_protos.find(c_qname);
+    if (it_fp != func_protos.end()) {
+        return &it_fp->second;
+    }
+
+    auto p = func_protos.insert(std::make_pair(
+        c_qname, FuncProto{return_type, param_types, is_std_function,
+                           cpp_qname, c_qname}));
+    return &p.first->second;
+}
+
+Span* process_span(const ClassTemplateSpecializationDecl* ctsd) {
+    // take the element type from the specialization rather than from how the
+    // type was spelled, since aliases like OIIO's cspan<T> add the const
+    QualifiedType element_type =
+        process_qualified_type(ctsd->getTemplateArgs()[0].getAsType());
+    // spell the namespaces the way records do, so that renamed ones like
+    // OIIO's versioned namespace match the rest of the generated code
+    const std::string cpp_qname = fmt::format(
+        "{}{}<{}>",
+        prefix_from_namespaces(get_namespaces(ctsd->getDeclContext()), "::"),
+        ctsd->getNameAsString(), get_cpp_spelling(element_type));
+
+    if (const Record* record = element_type.type.var.cast_or_null<Record>()) {
+        if (record->kind == RecordKind::OpaquePtr) {
+            fmt::print("ERROR: {} is a span of OpaquePtr records, which can't "
+                       "be allocated contiguously from C\n",
+                       cpp_qname);
+            throw std::runtime_error("unhandled span element type");
+        }
+    }
+
+    auto it_span = spans.find(cpp_qname);
+    if (it_span != spans.end()) {
+        return &it_span->second;
+    }
+
+    auto p = spans.insert(
+        std::make_pair(cpp_qname, Span{element_type, cpp_qname}));
+    return &p.first->second;
+}
+
+// Name of a map's key or value type for building the map's C name
+std::string get_map_element_name(const QualifiedType& qtype) {
+    if (qtype.type.name == "basic_string") {
+        return "string";
+    }
+    // builtins like unsigned int have spaces in them
+    return pystring::replace(qtype.type.get_c_qname(), " ", "_");
+}
+
+// Are the template arguments of a map or set after its key and value types
+// (the comparator, or the hasher and key equality, and then the allocator)
+// the defaults?
+bool has_default_map_arguments(const ClassTemplateSpecializationDecl* ctsd,
+                               bool is_set) {
+    const TemplateArgumentList& args = ctsd->getTemplateArgs();
+    const QualType key_type = args[0].getAsType().getCanonicalType();
+    std::vector<std::string> functors = {"less"};
+    if (pystring::startswith(ctsd->getNameAsString(), "unordered_")) {
+        functors = {"hash", "equal_to"};
+    }
+
+    unsigned index = is_set ? 1 : 2;
+    for (const auto& functor : functors) {
+        const auto* functor_decl =
+            dyn_cast_or_null<ClassTemplateSpecializationDecl>(
+                args[index++].getAsType()->getAsCXXRecordDecl());
+        if (functor_decl == nullptr || !functor_decl->isInStdNamespace() ||
+            functor_decl->getNameAsString() != functor ||
+            functor_decl->getTemplateArgs()[0]
+                    .getAsType()
+                    .getCanonicalType() != key_type) {
+            return false;
+        }
+    }
+
+    const auto* allocator_decl = args[index].getAsType()->getAsCXXRecordDecl();
+    return allocator_decl != nullptr && allocator_decl->isInStdNamespace() &&
+           allocator_decl->getNameAsString() == "allocator";
+}
+
+// A hash of name that's stable between compilers and standard libraries
+// (unlike std::hash), for disambiguating generated names
+uint32_t get_stable_hash(const std::string& name) {
+    // 32-bit FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const unsigned char c : name) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+}
+
+Map* process_map(const QualType& qt,
+                 const ClassTemplateSpecializationDecl* ctsd) {
+    const std::string kind = ctsd->getNameAsString();
+    const bool is_set = kind == "set" || kind == "unordered_set";
+    const TemplateArgumentList& args = ctsd->getTemplateArgs();
+    QualifiedType key_type = process_qualified_type(args[0].getAsType());
+    QualifiedType value_type =
+        is_set ? key_type : process_qualified_type(args[1].getAsType());
+
+    std::string c_qname =
+        fmt::format("cppmm_{}_{}", kind, get_map_element_name(key_type));
+    if (!is_set) {
+        c_qname += "_" + get_map_element_name(value_type);
+    }
+
+    // spell out the whole canonical type so that we keep any non-default
+    // comparator, hasher or allocator
+    PrintingPolicy policy(ctsd->getASTContext().getLangOpts());
+    policy.SuppressTagKeyword = true;
+    const std::string cpp_qname =
+        qt.getCanonicalType().getUnqualifiedType().getAsString(policy);
+
+    // and give those a name of their own so they don't collapse into the
+    // default container of the same key and value
+    if (!has_default_map_arguments(ctsd, is_set)) {
+        c_qname += fmt::format("_{:08x}", get_stable_hash(cpp_qname));
+    }
+
+    for (const auto* qtype : {&key_type, &value_type}) {
+        if (qtype->is_ptr || qtype->is_ref || qtype->is_uptr ||
+            !(qtype->type.var.is<Builtin>() || qtype->type.var.is<Enum>() ||
+              qtype->type.var.is<Record>() ||
+              qtype->type.name == "basic_string")) {
+            throw std::runtime_error(
+                fmt::format("{} has a key or value type that cannot be read "
+                            "from C",
+                            cpp_qname));
+        }
+    }
+
+    auto it_map = maps.find(c_qname);
+    if (it_map != maps.end()) {
+        return &it_map->second;
+    }
+
+    auto p = maps.insert(std::make_pair(
+        c_qname, Map{key_type, value_type, is_set, cpp_qname, c_qname}));
+    return &p.first->second;
+}
+
+SumType* process_sum_type(const QualType& qt,
+                          const ClassTemplateSpecializationDecl* ctsd) {
+    const std::string kind = ctsd->getNameAsString();
+    const TemplateArgumentList& args = ctsd->getTemplateArgs();
+    std::vector<QualifiedType> alternatives;
+    if (kind == "optional") {
+        alternatives.push_back(process_qualified_type(args[0].getAsType()));
+    } else {
+        // variant's alternatives are a single parameter pack
+        for (const auto& arg : args[0].pack_elements()) {
+            alternatives.push_back(process_qualified_type(arg.getAsType()));
+        }
+    }
+
+    std::vector<std::string> names;
+    for (const auto& qtype : alternatives) {
+        names.push_back(get_map_element_name(qtype));
+    }
+    const std::string c_qname =
+        fmt::format("cppmm_{}_{}", kind, pystring::join("_", names));
+
+    PrintingPolicy policy(ctsd->getASTContext().getLangOpts());
+    policy.SuppressTagKeyword = true;
+    const std::string cpp_qname =
+        qt.getCanonicalType().getUnqualifiedType().getAsString(policy);
+
+    for (const auto& qtype : alternatives) {
+        const Record* record = qtype.type.var.cast_or_null<Record>();
+        if (qtype.is_ptr || qtype.is_ref || qtype.is_uptr ||
+            !(qtype.type.var.is<Builtin>() || qtype.type.var.is<Enum>() ||
+              (record && record->kind != RecordKind::OpaquePtr))) {
+            throw std::runtime_error(
+                fmt::format("{} has an alternative that cannot be returned by "
+                            "value to C",
+                            cpp_qname));
+        }
+    }
+
+    auto it_sum = sum_types.find(c_qname);
+    if (it_sum != sum_types.end()) {
+        return &it_sum->second;
+    }
+
+    auto p = sum_types.insert(std::make_pair(
+        c_qname,
+        SumType{alternatives, kind == "optional", cpp_qname, c_qname}));
+    return &p.first->second;
+}
+
 QualifiedType process_pointee_type(const QualType& qt) {
     if (is_builtin(qt)) {
         std::string name = qt.getTypePtr()
@@ -184,6 +575,60 @@ QualifiedType process_pointee_type(const QualType& qt) {
                 process_pointee_type(tst->getArgs()->getAsType());
             qtype.is_uptr = true;
             qtype.is_const = qt.isConstQualified();
+            return qtype;
+        } else if (crd->getNameAsString() == "shared_ptr") {
+            const auto* tst = qt->getAs<TemplateSpecializationType>();
+            QualifiedType element_type =
+                process_pointee_type(tst->getArgs()->getAsType());
+            SharedPtr* sptr = process_shared_ptr(element_type);
+
+            QualifiedType qtype{Type{sptr->c_qname, sptr}};
+            qtype.requires_cast = true;
+            qtype.is_const = qt.isConstQualified();
+
+            return qtype;
+        } else if (crd->getNameAsString() == "span" &&
+                   isa<ClassTemplateSpecializationDecl>(crd)) {
+            Span* span =
+                process_span(cast<ClassTemplateSpecializationDecl>(crd));
+
+            QualifiedType qtype{Type{span->cpp_qname, span}};
+            qtype.is_const = qt.isConstQualified();
+
+            return qtype;
+        } else if ((crd->getNameAsString() == "map" ||
+                    crd->getNameAsString() == "unordered_map" ||
+                    crd->getNameAsString() == "set" ||
+                    crd->getNameAsString() == "unordered_set") &&
+                   crd->isInStdNamespace() &&
+                   isa<ClassTemplateSpecializationDecl>(crd)) {
+            Map* map =
+                process_map(qt, cast<ClassTemplateSpecializationDecl>(crd));
+
+            QualifiedType qtype{Type{map->c_qname, map}};
+            qtype.requires_cast = true;
+            qtype.is_const = qt.isConstQualified();
+
+            return qtype;
+        } else if ((crd->getNameAsString() == "optional" ||
+                    crd->getNameAsString() == "variant") &&
+                   crd->isInStdNamespace() &&
+                   isa<ClassTemplateSpecializationDecl>(crd)) {
+            SumType* sum = process_sum_type(
+                qt, cast<ClassTemplateSpecializationDecl>(crd));
+
+            // returned by value, so the C side never sees it const
+            return QualifiedType{Type{sum->c_qname, sum}};
+        } else if (crd->getNameAsString() == "function" &&
+                   crd->isInStdNamespace()) {
+            const auto* tst = qt->getAs<TemplateSpecializationType>();
+            const auto* fpt =
+                tst->getArgs()->getAsType()->getAs<FunctionProtoType>();
+            FuncProto* fp = process_func_proto(qt, fpt, true);
+
+            QualifiedType qtype{Type{fp->c_qname, fp}};
+            qtype.is_const = qt.isConstQualified();
+
             return qtype;
         } else if (crd->getNameAsString() == "vector") {
             const auto* tst = qt->getAs<TemplateSpecializationType>();
@@ -212,12 +657,18 @@ QualifiedType process_pointee_type(const QualType& qt) {
                 // fmt::print("ERROR: could not process record for {}\n",
                 //            crd->getNameAsString());
             }
-            std::string type_name = crd->getNameAsString();
+            // template specializations are referred to by their mangled C
+            // name
+            std::string type_name = record_ptr == nullptr
+                                        ? crd->getNameAsString()
+                                        : record_ptr->c_name;
             QualifiedType qtype{Type{
                 type_name, record_ptr,
                 cppmm::get_namespaces(qt->getAsCXXRecordDecl()->getParent())}};
-            qtype.requires_cast = !(crd->getNameAsString() == "basic_string" ||
-                                    crd->getNameAsString() == "string_view");
+            qtype.requires_cast =
+                !(crd->getNameAsString() == "basic_string" ||
+                  crd->getNameAsString() == "string_view" ||
+                  crd->getNameAsString() == "basic_string_view");
             qtype.is_const = qt.isConstQualified();
             return qtype;
         }
@@ -239,10 +690,29 @@ QualifiedType process_qualified_type(const QualType& qt) {
     bool is_ptr = qt->isPointerType();
     bool is_ref = qt->isReferenceType();
 
-    if (is_ptr || is_ref) {
+    if (const auto* cat =
+            dyn_cast_or_null<ConstantArrayType>(qt->getAsArrayTypeUnsafe())) {
+        // only valid for record fields: parameters have already decayed to
+        // pointers by the time we see them
+        QualifiedType result = process_qualified_type(cat->getElementType());
+        result.array_extents.insert(result.array_extents.begin(),
+                                    cat->getSize().getZExtValue());
+        return result;
+    } else if (qt->isFunctionPointerType()) {
+        const auto* fpt =
+            qt->getPointeeType()->getAs<FunctionProtoType>();
+        if (fpt == nullptr) {
+            fmt::print("ERROR unhandled function pointer type {}\n",
+                       qt.getAsString());
+            throw std::runtime_error("unhandled type");
+        }
+        FuncProto* fp = process_func_proto(qt, fpt, false);
+        return QualifiedType{Type{fp->c_qname, fp}};
+    } else if (is_ptr || is_ref) {
         QualifiedType result = process_pointee_type(qt->getPointeeType());
         result.is_ptr = is_ptr;
         result.is_ref = is_ref;
+        result.is_rref = qt->isRValueReferenceType();
         return result;
     } else if (is_builtin(qt)) {
         QualifiedType result = process_pointee_type(qt);
@@ -285,6 +755,534 @@ std::string get_decl_comment(const Decl* decl) {
     return result;
 }
 
+// Write the object representation of value, of type qt, into bytes at
+// offset. Returns false for anything we can't lay out ourselves (pointers,
+// unions, bitfields and virtual bases)
+bool write_constant_bytes(const APValue& value, QualType qt, ASTContext& ctx,
+                          size_t offset, std::vector<unsigned char>& bytes) {
+    qt = qt.getCanonicalType();
+    const size_t size = ctx.getTypeSizeInChars(qt).getQuantity();
+    if (offset + size > bytes.size()) {
+        return false;
+    }
+
+    llvm::APInt bits;
+    if (value.isInt()) {
+        bits = value.getInt().extOrTrunc(size * 8);
+    } else if (value.isFloat()) {
+        bits = value.getFloat().bitcastToAPInt().zextOrTrunc(size * 8);
+    } else if (value.isStruct()) {
+        const auto* crd = qt->getAsCXXRecordDecl();
+        if (crd == nullptr || crd->getNumVBases() != 0) {
+            return false;
+        }
+        const ASTRecordLayout& layout = ctx.getASTRecordLayout(crd);
+
+        unsigned index = 0;
+        for (const auto& base : crd->bases()) {
+            const auto* base_crd = base.getType()->getAsCXXRecordDecl();
+            const size_t base_offset =
+                layout.getBaseClassOffset(base_crd).getQuantity();
+            if (!write_constant_bytes(value.getStructBase(index),
+                                      base.getType(), ctx,
+                                      offset + base_offset, bytes)) {
+                return false;
+            }
+            ++index;
+        }
+
+        for (const auto* field : crd->fields()) {
+            if (field->isBitField()) {
+                return false;
+            }
+            const size_t field_offset =
+                layout.getFieldOffset(field->getFieldIndex()) / 8;
+            if (!write_constant_bytes(
+                    value.getStructField(field->getFieldIndex()),
+                    field->getType(), ctx, offset + field_offset, bytes)) {
+                return false;
+            }
+        }
+        return true;
+    } else if (value.isArray()) {
+        const auto* cat = ctx.getAsConstantArrayType(qt);
+        if (cat == nullptr) {
+            return false;
+        }
+        const size_t element_size =
+            ctx.getTypeSizeInChars(cat->getElementType()).getQuantity();
+        for (unsigned i = 0; i < value.getArraySize(); ++i) {
+            const APValue& element = i < value.getArrayInitializedElts()
+                                         ? value.getArrayInitializedElt(i)
+                                         : value.getArrayFiller();
+            if (!write_constant_bytes(element, cat->getElementType(), ctx,
+                                      offset + i * element_size, bytes)) {
+                return false;
+            }
+        }
+        return true;
+    } else {
+        return false;
+    }
+
+    const bool big_endian = ctx.getTargetInfo().isBigEndian();
+    for (size_t i = 0; i < size; ++i) {
+        const size_t byte = big_endian ? size - 1 - i : i;
+        bytes[offset + byte] = bits.extractBits(8, i * 8).getZExtValue();
+    }
+    return true;
+}
+
+// Format value as a C initializer for qt, matching the declarations we
+// generate: valuetypes get their fields in order and opaquebytes their
+// object representation. Returns an empty string if we can't
+std::string format_constant(const APValue& value, QualType qt,
+                            ASTContext& ctx) {
+    qt = qt.getCanonicalType();
+    if (qt->isBooleanType() && value.isInt()) {
+        return value.getInt().getBoolValue() ? "true" : "false";
+    } else if (value.isInt()) {
+        const llvm::APSInt& i = value.getInt();
+        if (i.getBitWidth() > 64) {
+            return "";
+        }
+        std::string suffix = i.isUnsigned() ? "u" : "";
+        if (i.getBitWidth() > 32) {
+            suffix += "ll";
+        }
+        if (i.isSigned() && i.isMinSignedValue() && i.getBitWidth() > 1) {
+            // -N is the negation of the literal N, which doesn't fit
+            return fmt::format("({}{} - 1)", i.getSExtValue() + 1, suffix);
+        }
+        if (i.isSigned()) {
+            return fmt::format("{}{}", i.getSExtValue(), suffix);
+        }
+        return fmt::format("{}{}", i.getZExtValue(), suffix);
+    } else if (value.isFloat()) {
+        const llvm::APFloat& f = value.getFloat();
+        if (!f.isFinite()) {
+            return "";
+        }
+        std::string suffix;
+        if (qt->isSpecificBuiltinType(BuiltinType::Float)) {
+            suffix = "f";
+        } else if (qt->isSpecificBuiltinType(BuiltinType::LongDouble)) {
+            suffix = "L";
+        } else if (!qt->isSpecificBuiltinType(BuiltinType::Double)) {
+            return "";
+        }
+        // hex float literals round-trip exactly
+        char buffer[64];
+        f.convertToHexString(buffer, 0, false,
+                             llvm::APFloat::rmNearestTiesToEven);
+        return fmt::format("{}{}", buffer, suffix);
+    } else if (value.isStruct()) {
+        const auto* crd = qt->getAsCXXRecordDecl();
+        const Record* record = crd ? process_record(crd) : nullptr;
+        if (record == nullptr) {
+            return "";
+        }
+
+        if (record->kind == RecordKind::OpaqueBytes) {
+            std::vector<unsigned char> bytes(record->size, 0);
+            if (!write_constant_bytes(value, qt, ctx, 0, bytes)) {
+                return "";
+            }
+            // cast each byte, since whether char is signed depends on the
+            // target, and a C++ brace initializer won't narrow 255 or -1
+            std::vector<std::string> elements;
+            for (unsigned char b : bytes) {
+                elements.push_back(fmt::format("(char)0x{:02x}", b));
+            }
+            return fmt::format("{{{{{}}}}}", pystring::join(", ", elements));
+        } else if (record->kind == RecordKind::ValueType &&
+                   value.getStructNumBases() == 0) {
+            std::vector<std::string> elements;
+            for (const auto* field : crd->fields()) {
+                std::string element = format_constant(
+                    value.getStructField(field->getFieldIndex()),
+                    field->getType(), ctx);
+                if (element.empty() || field->isBitField()) {
+                    return "";
+                }
+                elements.push_back(element);
+            }
+            return fmt::format("{{{}}}", pystring::join(", ", elements));
+        }
+    } else if (value.isArray()) {
+        const auto* cat = ctx.getAsConstantArrayType(qt);
+        if (cat == nullptr) {
+            return "";
+        }
+        std::vector<std::string> elements;
+        for (unsigned i = 0; i < value.getArraySize(); ++i) {
+            const APValue& element = i < value.getArrayInitializedElts()
+                                         ? value.getArrayInitializedElt(i)
+                                         : value.getArrayFiller();
+            elements.push_back(
+                format_constant(element, cat->getElementType(), ctx));
+            if (elements.back().empty()) {
+                return "";
+            }
+        }
+        return fmt::format("{{{}}}", pystring::join(", ", elements));
+    }
+
+    return "";
+}
+
+// Evaluate the value returned by a constexpr function with no parameters,
+// and return it as a C initializer. We only handle bodies that are a single
+// return statement, which covers the factory functions and constants that
+// we're interested in
+std::string evaluate_constant_value(const FunctionDecl* function,
+                                    const QualifiedType& return_type) {
+    if (!options.constant_values || !function->isConstexpr() ||
+        function->getNumParams() != 0 || return_type.is_ptr ||
+        return_type.is_ref || return_type.is_uptr) {
+        return "";
+    }
+
+    if (const Record* record = return_type.type.var.cast_or_null<Record>()) {
+        if (record->kind == RecordKind::OpaquePtr) {
+            return "";
+        }
+    } else if (!return_type.type.var.is<Builtin>() &&
+               !return_type.type.var.is<Enum>()) {
+        return "";
+    }
+
+    const FunctionDecl* definition = nullptr;
+    if (!function->hasBody(definition) || definition->isDependentContext()) {
+        return "";
+    }
+
+    const auto* body = dyn_cast_or_null<CompoundStmt>(definition->getBody());
+    if (body == nullptr || body->size() != 1) {
+        return "";
+    }
+
+    const auto* ret = dyn_cast<ReturnStmt>(body->body_front());
+    if (ret == nullptr || ret->getRetValue() == nullptr) {
+        return "";
+    }
+
+    ASTContext& ctx = function->getASTContext();
+    Expr::EvalResult result;
+    if (!ret->getRetValue()->EvaluateAsRValue(result, ctx) ||
+        result.HasSideEffects) {
+        return "";
+    }
+
+    return format_constant(result.Val, function->getReturnType(), ctx);
+}
+
+// Evaluate the public static constexpr data members of record, such as
+// TypeDesc::TypeFloat, that C can hold by value. A member declared const in
+// the class and defined constexpr after it counts too
+std::vector<ConstantMember>
+get_constant_members(const CXXRecordDecl* record) {
+    std::vector<ConstantMember> result;
+    if (record->isDependentContext()) {
+        return result;
+    }
+
+    ASTContext& ctx = record->getASTContext();
+    for (const auto* decl : record->decls()) {
+        const auto* var = dyn_cast<VarDecl>(decl);
+        if (var == nullptr || !var->isStaticDataMember() ||
+            var->getAccess() != AS_public) {
+            continue;
+        }
+
+        const VarDecl* definition = var->getDefinition();
+        if (definition == nullptr || !definition->isConstexpr() ||
+            definition->getInit() == nullptr ||
+            definition->getInit()->isValueDependent()) {
+            continue;
+        }
+
+        const QualifiedType qtype = process_qualified_type(var->getType());
+        if (qtype.is_ptr || qtype.is_ref || qtype.is_uptr ||
+            !qtype.array_extents.empty()) {
+            continue;
+        }
+        if (const Record* member_record =
+                qtype.type.var.cast_or_null<Record>()) {
+            if (member_record->kind == RecordKind::OpaquePtr) {
+                continue;
+            }
+        } else if (!qtype.type.var.is<Builtin>() &&
+                   !qtype.type.var.is<Enum>()) {
+            continue;
+        }
+
+        Expr::EvalResult value;
+        if (!definition->getInit()->EvaluateAsRValue(value, ctx) ||
+            value.HasSideEffects) {
+            continue;
+        }
+
+        const std::string formatted =
+            format_constant(value.Val, var->getType(), ctx);
+        if (!formatted.empty()) {
+            result.push_back(
+                ConstantMember{var->getNameAsString(), qtype, formatted});
+        }
+    }
+    return result;
+}
+
+// Can values of this type be used directly in a C expression
+bool is_inline_scalar(const QualifiedType& qtype) {
+    return !qtype.is_ptr && !qtype.is_ref && !qtype.is_uptr &&
+           qtype.array_extents.empty() &&
+           (qtype.type.var.is<Enum>() ||
+            (qtype.type.var.is<Builtin>() && qtype.type.name != "void"));
+}
+
+// Get the C spelling of an arithmetic or enum type
+std::string get_c_scalar_type(QualType qt) {
+    if (qt->isEnumeralType()) {
+        // enums are passed as int
+        return "int";
+    }
+    std::string name = qt.getCanonicalType().getUnqualifiedType().getAsString();
+    // C++ doesn't like _Bool but we can include stdbool.h for C
+    if (name == "_Bool") {
+        name = "bool";
+    }
+    return name;
+}
+
+// Translate expr, from the body of a method of record, to the equivalent C
+// expression. Only reads of scalar fields of this and of parameters,
+// literals, calls to constexpr functions with no arguments (folded to their
+// value), arithmetic, comparisons, ternaries and arithmetic conversions are
+// handled, so the result can't have any side effects. Returns an empty string
+// if the expression contains anything else. If opaque_fields is given the
+// record is OpaqueBytes, and the fields read are added to it to be copied
+// into locals rather than read through self
+std::string
+translate_inline_expression(const Expr* expr, const CXXRecordDecl* record,
+                            std::vector<InlineField>* opaque_fields) {
+    expr = expr->IgnoreParens();
+
+    if (const auto* ice = dyn_cast<ImplicitCastExpr>(expr)) {
+        switch (ice->getCastKind()) {
+        case CK_LValueToRValue:
+        case CK_NoOp:
+            return translate_inline_expression(ice->getSubExpr(), record,
+                                               opaque_fields);
+        case CK_IntegralCast:
+        case CK_IntegralToBoolean:
+        case CK_IntegralToFloating:
+        case CK_FloatingToIntegral:
+        case CK_FloatingToBoolean:
+        case CK_FloatingCast: {
+            // C applies the same conversions implicitly, but spell them out
+            // so that we don't depend on the context the result ends up in
+            const std::string sub = translate_inline_expression(
+                ice->getSubExpr(), record, opaque_fields);
+            if (sub.empty()) {
+                return "";
+            }
+            return fmt::format("(({}){})", get_c_scalar_type(ice->getType()),
+                               sub);
+        }
+        default:
+            return "";
+        }
+    } else if (const auto* ece = dyn_cast<ExplicitCastExpr>(expr)) {
+        // C-style, functional and static_cast between arithmetic types
+        if (!ece->getType()->isArithmeticType() ||
+            !ece->getSubExpr()->getType()->isArithmeticType() ||
+            isa<CXXReinterpretCastExpr>(ece) ||
+            isa<CXXConstCastExpr>(ece)) {
+            return "";
+        }
+        const std::string sub = translate_inline_expression(
+            ece->getSubExpr(), record, opaque_fields);
+        if (sub.empty()) {
+            return "";
+        }
+        return fmt::format("(({}){})", get_c_scalar_type(ece->getType()),
+                           sub);
+    } else if (const auto* me = dyn_cast<MemberExpr>(expr)) {
+        const auto* field = dyn_cast<FieldDecl>(me->getMemberDecl());
+        const auto* base =
+            dyn_cast<CXXThisExpr>(me->getBase()->IgnoreParenImpCasts());
+        if (field == nullptr || base == nullptr || field->isBitField() ||
+            field->getParent() != record ||
+            !field->getType()->isArithmeticType()) {
+            return "";
+        }
+        if (opaque_fields == nullptr) {
+            return fmt::format("self->{}", field->getNameAsString());
+        }
+
+        const std::string name = field->getNameAsString();
+        const auto it = std::find_if(
+            opaque_fields->begin(), opaque_fields->end(),
+            [&](const InlineField& f) { return f.name == name; });
+        if (it == opaque_fields->end()) {
+            const ASTRecordLayout& layout =
+                record->getASTContext().getASTRecordLayout(record);
+            opaque_fields->push_back(InlineField{
+                name, get_c_scalar_type(field->getType()),
+                (size_t)(layout.getFieldOffset(field->getFieldIndex()) / 8)});
+        }
+        return fmt::format("self_{}", name);
+    } else if (const auto* dre = dyn_cast<DeclRefExpr>(expr)) {
+        if (const auto* pvd = dyn_cast<ParmVarDecl>(dre->getDecl())) {
+            return pvd->getNameAsString();
+        } else if (const auto* ecd =
+                       dyn_cast<EnumConstantDecl>(dre->getDecl())) {
+            return fmt::format("{}", ecd->getInitVal().getExtValue());
+        }
+        return "";
+    } else if (const auto* il = dyn_cast<IntegerLiteral>(expr)) {
+        const std::string value =
+            fmt::format("{}", il->getValue().getZExtValue());
+        if (il->getType()->isSpecificBuiltinType(BuiltinType::Int)) {
+            return value;
+        }
+        return fmt::format("(({}){})", get_c_scalar_type(il->getType()),
+                           value);
+    } else if (const auto* call = dyn_cast<CallExpr>(expr)) {
+        // things like std::numeric_limits<int>::min(), which C has no
+        // equivalent of, so substitute the value
+        const FunctionDecl* callee = call->getDirectCallee();
+        if (callee == nullptr || !callee->isConstexpr() ||
+            call->getNumArgs() != 0 || isa<CXXMemberCallExpr>(call) ||
+            !call->getType()->isArithmeticType()) {
+            return "";
+        }
+        ASTContext& ctx = record->getASTContext();
+        Expr::EvalResult result;
+        if (!call->EvaluateAsRValue(result, ctx) || result.HasSideEffects) {
+            return "";
+        }
+        return format_constant(result.Val, call->getType(), ctx);
+    } else if (const auto* bl = dyn_cast<CXXBoolLiteralExpr>(expr)) {
+        return bl->getValue() ? "true" : "false";
+    } else if (const auto* fl = dyn_cast<FloatingLiteral>(expr)) {
+        std::string suffix;
+        if (fl->getType()->isSpecificBuiltinType(BuiltinType::Float)) {
+            suffix = "f";
+        } else if (fl->getType()->isSpecificBuiltinType(
+                       BuiltinType::LongDouble)) {
+            suffix = "L";
+        }
+        char buffer[64];
+        fl->getValue().convertToHexString(buffer, 0, false,
+                                          llvm::APFloat::rmNearestTiesToEven);
+        return fmt::format("{}{}", buffer, suffix);
+    } else if (const auto* uo = dyn_cast<UnaryOperator>(expr)) {
+        const char* op = nullptr;
+        switch (uo->getOpcode()) {
+        case UO_Minus:
+            op = "-";
+            break;
+        case UO_Plus:
+            op = "+";
+            break;
+        case UO_Not:
+            op = "~";
+            break;
+        case UO_LNot:
+            op = "!";
+            break;
+        default:
+            return "";
+        }
+        const std::string sub = translate_inline_expression(
+            uo->getSubExpr(), record, opaque_fields);
+        if (sub.empty()) {
+            return "";
+        }
+        return fmt::format("({}{})", op, sub);
+    } else if (const auto* bo = dyn_cast<BinaryOperator>(expr)) {
+        if (bo->isAssignmentOp() || bo->isCompoundAssignmentOp() ||
+            bo->isCommaOp() || bo->isPtrMemOp()) {
+            return "";
+        }
+        const std::string lhs =
+            translate_inline_expression(bo->getLHS(), record, opaque_fields);
+        const std::string rhs =
+            translate_inline_expression(bo->getRHS(), record, opaque_fields);
+        if (lhs.empty() || rhs.empty()) {
+            return "";
+        }
+        return fmt::format("({} {} {})", lhs, bo->getOpcodeStr().str(), rhs);
+    } else if (const auto* co = dyn_cast<ConditionalOperator>(expr)) {
+        const std::string cond =
+            translate_inline_expression(co->getCond(), record, opaque_fields);
+        const std::string lhs = translate_inline_expression(
+            co->getTrueExpr(), record, opaque_fields);
+        const std::string rhs = translate_inline_expression(
+            co->getFalseExpr(), record, opaque_fields);
+        if (cond.empty() || lhs.empty() || rhs.empty()) {
+            return "";
+        }
+        return fmt::format("({} ? {} : {})", cond, lhs, rhs);
+    }
+
+    return "";
+}
+
+// Get the C expression for the body of method if it's a single return of
+// something translate_inline_expression() can handle
+std::string get_inline_expression(const CXXMethodDecl* method,
+                                  const cppmm::Method& result,
+                                  const cppmm::Record* record,
+                                  std::vector<InlineField>& inline_fields) {
+    if (!options.inline_accessors || record->kind == RecordKind::OpaquePtr ||
+        result.is_static || result.is_constructor ||
+        !is_inline_scalar(result.return_type)) {
+        return "";
+    }
+
+    for (const auto& param : result.params) {
+        if (!is_inline_scalar(param.qtype)) {
+            return "";
+        }
+    }
+
+    const FunctionDecl* definition = nullptr;
+    if (!method->hasBody(definition) || definition->isDependentContext()) {
+        return "";
+    }
+
+    const auto* body = dyn_cast_or_null<CompoundStmt>(definition->getBody());
+    if (body == nullptr || body->size() != 1) {
+        return "";
+    }
+
+    const auto* ret = dyn_cast<ReturnStmt>(body->body_front());
+    if (ret == nullptr || ret->getRetValue() == nullptr) {
+        return "";
+    }
+
+    // parameter names in the definition may differ from the declaration we
+    // use in the C signature, so only translate if they match
+    for (unsigned i = 0; i < definition->getNumParams(); ++i) {
+        if (definition->getParamDecl(i)->getNameAsString() !=
+            result.params[i].name) {
+            return "";
+        }
+    }
+
+    std::vector<InlineField> fields;
+    const std::string expression = translate_inline_expression(
+        ret->getRetValue(), method->getParent(),
+        record->kind == RecordKind::OpaqueBytes ? &fields : nullptr);
+    if (!expression.empty()) {
+        inline_fields = fields;
+    }
+    return expression;
+}
+
 cppmm::Function process_function(const FunctionDecl* function,
                                  const cppmm::ExportedFunction& ex_function,
                                  std::vector<std::string> namespaces) {
@@ -298,7 +1296,7 @@ cppmm::Function process_function(const FunctionDecl* function,
 
     std::string comment = get_decl_comment(function);
 
-    return cppmm::Function{
+    cppmm::Function result{
         ex_function.cpp_name,
         ex_function.c_name,
         process_qualified_type(function->getReturnType()),
@@ -306,6 +1304,15 @@ cppmm::Function process_function(const FunctionDecl* function,
         comment,
         namespaces,
     };
+    result.is_batch = ex_function.is_batch();
+    result.is_constexpr = function->isConstexpr();
+    result.constant_value =
+        evaluate_constant_value(function, result.return_type);
+    if (const auto* fpt = function->getType()->getAs<FunctionProtoType>()) {
+        result.is_noexcept = fpt->isNothrow();
+    }
+
+    return result;
 }
 
 cppmm::Method process_method(const CXXMethodDecl* method,
@@ -323,6 +1330,8 @@ cppmm::Method process_method(const CXXMethodDecl* method,
     bool is_constructor = false;
     bool is_copy_constructor = false;
     bool is_copy_assignment = method->isCopyAssignmentOperator();
+    bool is_move_constructor = false;
+    bool is_move_assignment = method->isMoveAssignmentOperator();
     bool is_operator = false;
     bool is_conversion_operator = false;
     std::string op;
@@ -331,6 +1340,7 @@ cppmm::Method process_method(const CXXMethodDecl* method,
         const auto* ctor = cast<CXXConstructorDecl>(method);
         is_constructor = true;
         is_copy_constructor = ctor->isCopyConstructor();
+        is_move_constructor = ctor->isMoveConstructor();
     } else if (ex_method.cpp_name.find("operator") == 0) {
         // we assume that clang always concatenates the operator name with the
         // symbols so we can use this to tell the difference with a conversion
@@ -349,15 +1359,16 @@ cppmm::Method process_method(const CXXMethodDecl* method,
     }
 
     // do some parameter patching. clang ignores the parameter name for copy
-    // ctor and assignment but we need one so just use "other"
-    if (is_copy_constructor || is_copy_assignment) {
+    // and move ctor and assignment but we need one so just use "other"
+    if (is_copy_constructor || is_copy_assignment || is_move_constructor ||
+        is_move_assignment) {
         params[0].name = "other";
     }
 
     std::vector<std::string> namespaces = record->namespaces;
     namespaces.push_back(record->c_name);
 
-    return cppmm::Method{ex_method.cpp_name,
+    cppmm::Method result{ex_method.cpp_name,
                          ex_method.c_name,
                          process_qualified_type(method->getReturnType()),
                          params,
@@ -368,9 +1379,24 @@ cppmm::Method process_method(const CXXMethodDecl* method,
                          is_constructor,
                          is_copy_constructor,
                          is_copy_assignment,
+                         is_move_constructor,
+                         is_move_assignment,
                          is_operator,
                          is_conversion_operator,
                          op};
+    result.is_batch = ex_method.is_batch();
+    result.is_constexpr = method->isConstexpr();
+    if (method->isStatic()) {
+        result.constant_value =
+            evaluate_constant_value(method, result.return_type);
+    }
+    result.inline_expression =
+        get_inline_expression(method, result, record, result.inline_fields);
+    if (const auto* fpt = method->getType()->getAs<FunctionProtoType>()) {
+        result.is_noexcept = fpt->isNothrow();
+    }
+
+    return result;
 }
 
 } // namespace cppmm
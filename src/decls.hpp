@@ -2,9 +2,14 @@
 
 #include "enum.hpp"
 #include "exports.hpp"
+#include "func_proto.hpp"
 #include "function.hpp"
+#include "map.hpp"
 #include "method.hpp"
 #include "record.hpp"
+#include "shared_ptr.hpp"
+#include "span.hpp"
+#include "sum_type.hpp"
 #include "vector.hpp"
 
 #include <clang/AST/DeclCXX.h>
@@ -23,11 +28,21 @@ using FileMap = std::unordered_map<std::string, File>;
 using RecordMap = std::unordered_map<std::string, Record>;
 using EnumMap = std::unordered_map<std::string, Enum>;
 using VectorMap = std::unordered_map<std::string, Vector>;
+using SharedPtrMap = std::unordered_map<std::string, SharedPtr>;
+using FuncProtoMap = std::unordered_map<std::string, FuncProto>;
+using SpanMap = std::unordered_map<std::string, Span>;
+using MapMap = std::unordered_map<std::string, Map>;
+using SumTypeMap = std::unordered_map<std::string, SumType>;
 
 extern FileMap files;
 extern RecordMap records;
 extern EnumMap enums;
 extern VectorMap vectors;
+extern SharedPtrMap shared_ptrs;
+extern FuncProtoMap func_protos;
+extern SpanMap spans;
+extern MapMap maps;
+extern SumTypeMap sum_types;
 
 bool is_builtin(const clang::QualType& qt);
 
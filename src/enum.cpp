@@ -1,4 +1,5 @@
 #include "enum.hpp"
+#include "options.hpp"
 
 #include <fmt/format.h>
 
@@ -15,4 +16,42 @@ std::string Enum::get_declaration() const {
     declarations += "};\n\n";
     return declarations;
 }
+
+std::string
+Enum::get_reflection_declaration(const std::string& export_prefix) const {
+    if (!options.reflection) {
+        return "";
+    }
+
+    return fmt::format("{}extern const cppmm_enum_info cppmm_reflect_{};\n\n",
+                       export_prefix, c_qname);
+}
+
+std::string Enum::get_reflection_definition() const {
+    if (!options.reflection) {
+        return "";
+    }
+
+    std::string result;
+    std::string enumerators_table = "NULL";
+    if (!enumerators.empty()) {
+        result += fmt::format(
+            "static const cppmm_enumerator_info cppmm_reflect_{}_enumerators[] "
+            "= {{\n",
+            c_qname);
+        for (const auto& ecd : enumerators) {
+            // refer to the C enumerator rather than repeating its value
+            result += fmt::format("    {{\"{0}\", {1}_{0}}},\n", ecd.first,
+                                  c_qname);
+        }
+        result += "};\n";
+        enumerators_table =
+            fmt::format("cppmm_reflect_{}_enumerators", c_qname);
+    }
+
+    result += fmt::format("const cppmm_enum_info cppmm_reflect_{0} = "
+                          "{{\"{0}\", {1}, {2}}};\n\n",
+                          c_qname, enumerators_table, enumerators.size());
+    return result;
+}
 } // namespace cppmm
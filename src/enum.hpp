@@ -13,8 +13,17 @@ struct Enum {
     std::vector<std::pair<std::string, uint64_t>> enumerators;
     std::string cpp_qname;
     std::string c_qname;
+    // C spelling of the enum's underlying integer type, for where a C caller
+    // reads the enum in place rather than as a converted int
+    std::string underlying_type;
 
     std::string get_declaration() const;
+    // Get the extern declaration of the enum's -reflection table, or an
+    // empty string if reflection is off
+    std::string
+    get_reflection_declaration(const std::string& export_prefix) const;
+    // Get the definition of that table and its static const enumerator array
+    std::string get_reflection_definition() const;
 };
 
 }
@@ -33,6 +33,14 @@ struct ExportedFunction {
         return false;
     }
 
+    bool is_batch() const {
+        for (const auto& attr : attrs) {
+            if (attr.kind == AttrDesc::Kind::Batch)
+                return true;
+        }
+        return false;
+    }
+
     std::string cpp_name;
     std::string c_name; //< may be different if we rename it
     std::string return_type;
@@ -49,6 +57,18 @@ struct ExportedMethod : public ExportedFunction {
         : ExportedFunction(clang::dyn_cast<clang::FunctionDecl>(method),
                            attrs) {
         is_const = method->isConst();
+
+        // give move constructors and assignments usable C names if they
+        // weren't renamed
+        if (c_name == cpp_name) {
+            const auto* ctor =
+                clang::dyn_cast<clang::CXXConstructorDecl>(method);
+            if (ctor && ctor->isMoveConstructor()) {
+                c_name = "move_from";
+            } else if (method->isMoveAssignmentOperator()) {
+                c_name = "move_assign";
+            }
+        }
     }
 
     bool is_const = false;
@@ -56,6 +76,9 @@ struct ExportedMethod : public ExportedFunction {
 
 struct ExportedRecord {
     std::string cpp_name;
+    // name to match the record against in the library. The same as cpp_name
+    // except for template specializations, where it's the template's name
+    std::string match_name;
     std::vector<std::string> namespaces;
     std::string c_name;
     RecordKind kind;
@@ -73,6 +96,8 @@ struct ExportedEnum {
 
 struct ExportedClass {
     std::string name;
+    // see ExportedRecord::match_name
+    std::string match_name;
     std::string filename;
     std::vector<std::string> namespaces;
     std::vector<ExportedMethod> methods;
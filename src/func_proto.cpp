@@ -0,0 +1,115 @@
+#include "func_proto.hpp"
+#include "enum.hpp"
+#include "record.hpp"
+
+#include "pystring.h"
+
+#include <fmt/format.h>
+
+namespace cppmm {
+
+namespace ps = pystring;
+
+namespace {
+
+// Convert expr, an argument the C++ side is passing to the callback, to its C
+// type
+std::string convert_to_c(const QualifiedType& qtype, const std::string& expr) {
+    if (const Record* record = qtype.type.var.cast_or_null<Record>()) {
+        if (qtype.is_ptr) {
+            return fmt::format("to_c({})", expr);
+        } else if (qtype.is_ref) {
+            return fmt::format("to_c(&{})", expr);
+        }
+        return fmt::format("bit_cast<{}>({})", record->c_qname, expr);
+    } else if (qtype.type.var.is<Enum>()) {
+        return fmt::format("(int){}", expr);
+    }
+    return expr;
+}
+
+// Convert expr, the value returned by the C callback, back to its C++ type
+std::string convert_to_cpp(const QualifiedType& qtype,
+                           const std::string& expr) {
+    if (const Record* record = qtype.type.var.cast_or_null<Record>()) {
+        if (qtype.is_ptr) {
+            return fmt::format("to_cpp({})", expr);
+        } else if (qtype.is_ref) {
+            return fmt::format("*to_cpp({})", expr);
+        }
+        return fmt::format("bit_cast<{}>({})", record->cpp_qname, expr);
+    } else if (const Enum* enm = qtype.type.var.cast_or_null<Enum>()) {
+        return fmt::format("({}){}", enm->cpp_qname, expr);
+    }
+    return expr;
+}
+
+} // namespace
+
+std::string get_cpp_spelling(const QualifiedType& qtype) {
+    std::string result;
+    if (qtype.is_const) {
+        result = "const ";
+    }
+    if (qtype.type.name == "basic_string") {
+        result += "std::string";
+    } else {
+        result += qtype.type.get_cpp_qname();
+    }
+    if (qtype.is_ptr) {
+        result += "*";
+    } else if (qtype.is_rref) {
+        result += "&&";
+    } else if (qtype.is_ref) {
+        result += "&";
+    }
+    return result;
+}
+
+std::string FuncProto::get_declaration() const {
+    std::vector<std::string> param_decls;
+    if (is_std_function) {
+        param_decls.push_back("void* user_data");
+    }
+    for (const auto& qtype : param_types) {
+        param_decls.push_back(qtype.create_c_declaration());
+    }
+    if (param_decls.empty()) {
+        param_decls.push_back("void");
+    }
+
+    return fmt::format(R"#(#ifndef CPPMM_CALLBACK_{0}
+#define CPPMM_CALLBACK_{0}
+typedef {1} (*{0})({2});
+#endif
+)#",
+                       c_qname, return_type.create_c_declaration(),
+                       ps::join(", ", param_decls));
+}
+
+std::string FuncProto::create_call(const std::string& name) const {
+    if (!is_std_function) {
+        // process_func_proto only lets through signatures whose C and C++
+        // spellings differ in pointer types, which have the same
+        // representation
+        return fmt::format("reinterpret_cast<{}>({})", cpp_qname, name);
+    }
+
+    std::vector<std::string> lambda_params;
+    std::vector<std::string> args = {name + "_data"};
+    for (size_t i = 0; i < param_types.size(); ++i) {
+        const std::string arg = fmt::format("_a{}", i);
+        lambda_params.push_back(
+            fmt::format("{} {}", get_cpp_spelling(param_types[i]), arg));
+        args.push_back(convert_to_c(param_types[i], arg));
+    }
+
+    const std::string call =
+        fmt::format("{}({})", name, ps::join(", ", args));
+    return fmt::format(
+        "{0} == nullptr ? {1}() : {1}([{0}, {0}_data]({2}) {{ return {3}; }})",
+        name, cpp_qname, ps::join(", ", lambda_params),
+        convert_to_cpp(return_type, call));
+}
+
+} // namespace cppmm
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "type.hpp"
+
+namespace cppmm {
+
+// A callback parameter. Raw function pointers are passed straight through,
+// while std::function is passed as a C function pointer taking an extra
+// leading void* user data argument, which is wrapped in a lambda at the call
+// site. The lambda only captures the two pointers so it fits in
+// std::function's small buffer and binding it doesn't allocate.
+struct FuncProto {
+    QualifiedType return_type;
+    std::vector<QualifiedType> param_types;
+    bool is_std_function;
+    std::string cpp_qname;
+    // name of the C function pointer typedef
+    std::string c_qname;
+
+    // Get the typedef of the C function pointer. It's guarded so that every
+    // header that uses it can declare it
+    std::string get_declaration() const;
+
+    // Get the expression converting the C parameter name (and name_data for
+    // a std::function) to the C++ callback type
+    std::string create_call(const std::string& name) const;
+};
+
+// Get how qtype is spelled in C++
+std::string get_cpp_spelling(const QualifiedType& qtype);
+
+} // namespace cppmm
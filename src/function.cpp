@@ -1,13 +1,21 @@
 #include "function.hpp"
 #include "enum.hpp"
+#include "func_proto.hpp"
+#include "map.hpp"
 #include "namespaces.hpp"
+#include "options.hpp"
 #include "record.hpp"
+#include "shared_ptr.hpp"
+#include "span.hpp"
+#include "sum_type.hpp"
 #include "vector.hpp"
 
 #include "pystring.h"
 
 #include <fmt/format.h>
 
+#include <algorithm>
+
 namespace cppmm {
 
 namespace ps = pystring;
@@ -34,27 +42,176 @@ std::string Function::get_declaration(
         } else if (const Enum* enm =
                        param.qtype.type.var.cast_or_null<Enum>()) {
             includes.insert(enm->filename);
+        } else if (const SharedPtr* sptr =
+                       param.qtype.type.var.cast_or_null<SharedPtr>()) {
+            insert_shared_ptr_includes(*sptr, includes,
+                                       casts_macro_invocations);
+        } else if (const FuncProto* fp =
+                       param.qtype.type.var.cast_or_null<FuncProto>()) {
+            insert_func_proto_includes(*fp, includes,
+                                       casts_macro_invocations);
+        } else if (const Span* span =
+                       param.qtype.type.var.cast_or_null<Span>()) {
+            insert_span_includes(*span, includes, casts_macro_invocations);
+        } else if (const Map* map = param.qtype.type.var.cast_or_null<Map>()) {
+            insert_map_includes(*map, includes, casts_macro_invocations);
         }
 
         std::string pdecl = param.create_c_declaration();
         param_decls.push_back(pdecl);
     }
 
-    std::string ret;
+    std::string ret = get_c_return_declaration(return_type, param_decls);
+    if (const Record* record = return_type.type.var.cast_or_null<Record>()) {
+        casts_macro_invocations.insert(record->create_casts());
+    } else if (const SharedPtr* sptr =
+                   return_type.type.var.cast_or_null<SharedPtr>()) {
+        insert_shared_ptr_includes(*sptr, includes, casts_macro_invocations);
+    } else if (const Map* map = return_type.type.var.cast_or_null<Map>()) {
+        insert_map_includes(*map, includes, casts_macro_invocations);
+    } else if (const SumType* sum =
+                   return_type.type.var.cast_or_null<SumType>()) {
+        insert_sum_type_includes(*sum, includes, casts_macro_invocations);
+    }
+
+    return fmt::format("{} {}({})", ret, c_qname, ps::join(", ", param_decls));
+}
+
+void insert_shared_ptr_includes(const SharedPtr& sptr,
+                                std::set<std::string>& includes,
+                                std::set<std::string>& casts_macro_invocations) {
+    // the handle is declared alongside its element's record
+    casts_macro_invocations.insert(sptr.create_casts());
+    if (const Record* record =
+            sptr.element_type.type.var.cast_or_null<Record>()) {
+        includes.insert(record->filename);
+        casts_macro_invocations.insert(record->create_casts());
+    }
+}
+
+void insert_func_proto_includes(const FuncProto& fp,
+                                std::set<std::string>& includes,
+                                std::set<std::string>& casts_macro_invocations) {
+    std::vector<QualifiedType> qtypes = fp.param_types;
+    qtypes.push_back(fp.return_type);
+    for (const auto& qtype : qtypes) {
+        if (const Record* record = qtype.type.var.cast_or_null<Record>()) {
+            includes.insert(record->filename);
+            casts_macro_invocations.insert(record->create_casts());
+        } else if (const Enum* enm = qtype.type.var.cast_or_null<Enum>()) {
+            includes.insert(enm->filename);
+        }
+    }
+}
+
+void insert_span_includes(const Span& span, std::set<std::string>& includes,
+                          std::set<std::string>& casts_macro_invocations) {
+    if (const Record* record =
+            span.element_type.type.var.cast_or_null<Record>()) {
+        includes.insert(record->filename);
+        casts_macro_invocations.insert(record->create_casts());
+    } else if (const Enum* enm =
+                   span.element_type.type.var.cast_or_null<Enum>()) {
+        includes.insert(enm->filename);
+    }
+}
+
+void insert_map_includes(const Map& map, std::set<std::string>& includes,
+                         std::set<std::string>& casts_macro_invocations) {
+    // the handle is declared alongside its home record, or in
+    // cppmm_containers.h which every header includes
+    casts_macro_invocations.insert(map.create_casts());
+    if (const Record* record = map.get_home_record()) {
+        includes.insert(record->filename);
+    }
+}
+
+void insert_sum_type_includes(const SumType& sum,
+                              std::set<std::string>& includes,
+                              std::set<std::string>& casts_macro_invocations) {
+    for (const auto& qtype : sum.alternatives) {
+        if (const Record* record = qtype.type.var.cast_or_null<Record>()) {
+            includes.insert(record->filename);
+            casts_macro_invocations.insert(record->create_casts());
+        } else if (const Enum* enm = qtype.type.var.cast_or_null<Enum>()) {
+            includes.insert(enm->filename);
+        }
+    }
+}
+
+std::string get_guarded_type_declarations(const Function& function) {
+    std::string result;
+    for (const auto& param : function.params) {
+        if (const FuncProto* fp =
+                param.qtype.type.var.cast_or_null<FuncProto>()) {
+            result += fp->get_declaration();
+        }
+    }
+    if (const SumType* sum =
+            function.return_type.type.var.cast_or_null<SumType>()) {
+        result += sum->get_declaration();
+    }
+    return result;
+}
+
+bool is_string_view(const QualifiedType& qtype) {
+    return qtype.type.name == "string_view" ||
+           qtype.type.name == "basic_string_view";
+}
+
+bool is_out_param_return(const QualifiedType& return_type) {
+    if (return_type.is_ptr || return_type.is_ref || return_type.is_uptr) {
+        return false;
+    }
+
+    if (const Record* record = return_type.type.var.cast_or_null<Record>()) {
+        // an OpaquePtr returned by value has nowhere else to go without
+        // allocating, so always hand it back through the caller's storage
+        return record->kind == RecordKind::OpaquePtr ||
+               (record->kind == RecordKind::OpaqueBytes &&
+                options.out_param_returns);
+    }
+
+    // node containers may point back into themselves (libstdc++'s rb-tree
+    // header and single bucket), so moving their bytes to another address
+    // on the way out would corrupt them
+    if (return_type.type.var.is<Map>()) {
+        return true;
+    }
+
+    return (return_type.type.var.is<Vector>() ||
+            return_type.type.var.is<SharedPtr>()) &&
+           options.out_param_returns;
+}
+
+std::string get_c_return_declaration(const QualifiedType& return_type,
+                                     std::vector<std::string>& param_decls) {
     if (return_type.type.name == "basic_string" && !return_type.is_ref &&
         !return_type.is_ptr) {
-        ret = "int";
+        if (options.owned_strings) {
+            // the string is moved into storage provided by the caller
+            param_decls.push_back("cppmm_string* _result");
+            return "void";
+        }
         param_decls.push_back("char* _result_buffer_ptr");
         param_decls.push_back("int _result_buffer_len");
-    } else {
-        ret = return_type.create_c_declaration();
-        if (const Record* record =
-                return_type.type.var.cast_or_null<Record>()) {
-            casts_macro_invocations.insert(record->create_casts());
-        }
+        return "int";
+    } else if (return_type.type.name == "basic_string" && return_type.is_ref &&
+               options.owned_strings) {
+        return "cppmm_string_view";
+    } else if (is_string_view(return_type) && !return_type.is_ref &&
+               !return_type.is_ptr) {
+        // a string_view is not NUL-terminated so always hand back the length
+        return "cppmm_string_view";
+    } else if (is_out_param_return(return_type)) {
+        QualifiedType result_type = return_type;
+        result_type.is_const = false;
+        param_decls.push_back(
+            fmt::format("{}* _result", result_type.create_c_declaration()));
+        return "void";
     }
 
-    return fmt::format("{} {}({})", ret, c_qname, ps::join(", ", param_decls));
+    return return_type.create_c_declaration();
 }
 
 std::string Function::get_definition(const std::string& declaration) const {
@@ -68,12 +225,23 @@ std::string Function::get_definition(const std::string& declaration) const {
     const std::string call_prefix = cpp_qname;
     const TypeVariant& return_var = return_type.type.var;
 
-    if (return_type.type.name == "basic_string" && return_type.is_ref) {
+    if (is_string_view(return_type) && !return_type.is_ref &&
+        !return_type.is_ptr) {
+        body = get_return_string_view_body(*this, call_prefix, call_params);
+    } else if (return_type.type.name == "basic_string" && return_type.is_ref &&
+               options.owned_strings) {
+        body = get_return_string_view_body(*this, call_prefix, call_params);
+    } else if (return_type.type.name == "basic_string" && return_type.is_ref) {
         body = get_return_string_ref_body(*this, call_prefix, call_params);
+    } else if (return_type.type.name == "basic_string" && !return_type.is_ref &&
+               options.owned_strings) {
+        body = get_return_string_owned_body(*this, call_prefix, call_params);
     } else if (return_type.type.name == "basic_string" && !return_type.is_ref) {
         body = get_return_string_copy_body(*this, call_prefix, call_params);
     } else if (return_type.is_uptr) {
         body = get_return_uniqueptr_body(*this, call_prefix, call_params);
+    } else if (is_out_param_return(return_type)) {
+        body = get_return_out_param_body(*this, call_prefix, call_params);
     } else if (const Record* record = return_var.cast_or_null<Record>()) {
         if (record->kind == RecordKind::ValueType) {
             body = get_return_valuetype_body(*this, call_prefix, call_params);
@@ -82,15 +250,269 @@ std::string Function::get_definition(const std::string& declaration) const {
         } else {
             body = get_return_opaqueptr_body(*this, call_prefix, call_params);
         }
-    } else if (return_var.is<Vector>()) {
+    } else if (return_var.is<Vector>() || return_var.is<SharedPtr>()) {
         body = get_return_opaquebytes_body(*this, call_prefix, call_params);
+    } else if (return_var.is<Map>()) {
+        body = get_return_map_reference_body(*this, call_prefix, call_params);
+    } else if (const SumType* sum = return_var.cast_or_null<SumType>()) {
+        body = sum->get_return_body(fmt::format("{}({})", call_prefix,
+                                                ps::join(", ", call_params)));
     } else if (return_type.type.name == "void") {
         body = get_return_void_body(*this, call_prefix, call_params);
     } else {
         body = get_return_builtin_body(*this, call_prefix, call_params);
     }
 
-    return fmt::format("{} {{\n{}\n}}", declaration, body);
+    return fmt::format("{} {{\n{}\n}}", declaration,
+                       get_exception_safe_body(*this, declaration, body));
+}
+
+std::string get_exception_safe_body(const Function& function,
+                                    const std::string& declaration,
+                                    const std::string& body) {
+    if (!options.catch_exceptions || function.is_noexcept) {
+        return body;
+    }
+
+    std::vector<std::string> lines;
+    ps::splitlines(body, lines);
+    for (auto& line : lines) {
+        if (!line.empty()) {
+            line = "    " + line;
+        }
+    }
+
+    return fmt::format(R"#(    try {{
+{}
+    }} catch (...) {{
+        cppmm_set_error_from_current_exception();
+        return{};
+    }})#",
+                       ps::join("\n", lines),
+                       ps::startswith(declaration, "void ") ? "" : " {}");
+}
+
+std::string get_constant_declaration(const Function& function) {
+    if (function.constant_value.empty()) {
+        return "";
+    }
+
+    QualifiedType value_type = function.return_type;
+    value_type.is_const = false;
+    return fmt::format("static const {} {}_value = {};\n",
+                       value_type.create_c_declaration(), function.c_qname,
+                       function.constant_value);
+}
+
+std::string get_c_attributes(const Function& function, bool has_self,
+                             bool self_const, bool returns_ownership) {
+    if (!options.c_attributes) {
+        return "";
+    }
+
+    // work out which C parameters are pointers, and which of those came from
+    // C++ references (and so can't be null)
+    std::vector<std::string> nonnull;
+    bool reads_memory = false;
+    bool writes_memory = false;
+    bool uses_strings = is_string_view(function.return_type) ||
+                        function.return_type.type.name == "basic_string";
+    int index = 1;
+    if (has_self) {
+        nonnull.push_back("1");
+        reads_memory = true;
+        writes_memory = !self_const;
+        ++index;
+    }
+
+    for (const auto& p : function.params) {
+        if (p.qtype.type.name == "basic_string" || is_string_view(p.qtype)) {
+            uses_strings = true;
+        }
+
+        if (p.is_string_slice()) {
+            // an empty slice may well have a null pointer
+            reads_memory = true;
+            index += 2;
+            continue;
+        }
+
+        const std::string decl = p.create_c_declaration();
+        if (decl.find('*') != std::string::npos) {
+            reads_memory = true;
+            if (decl.find("const ") != 0) {
+                writes_memory = true;
+            }
+            // an empty span or std::function may well have a null pointer
+            if (p.qtype.is_ref && !p.qtype.type.var.is<Span>() &&
+                !p.qtype.type.var.is<FuncProto>()) {
+                nonnull.push_back(std::to_string(index));
+            }
+        }
+        // spans and std::functions take two C parameters
+        index += std::count(decl.begin(), decl.end(), ',') + 1;
+    }
+
+    // any out parameters added for the return value are written to
+    std::vector<std::string> return_params;
+    get_c_return_declaration(function.return_type, return_params);
+    if (!return_params.empty()) {
+        writes_memory = true;
+    }
+
+    std::vector<std::string> attrs;
+    const bool returns_value = !(function.return_type.type.name == "void" &&
+                                 !function.return_type.is_ptr);
+    if (function.is_constexpr && function.is_noexcept &&
+        !options.catch_exceptions && returns_value && !writes_memory &&
+        !returns_ownership) {
+        // a constexpr function can only have side effects through its
+        // arguments, and we've checked there are none it could write to. It
+        // must not throw either, and the -catch-exceptions wrapper writes the
+        // thread's error state, so neither may be assumed away by the caller
+        attrs.push_back(reads_memory ? "pure" : "const");
+    }
+
+    // the wrapper itself may allocate (and throw) for strings and
+    // constructors even if the wrapped function doesn't
+    if (function.is_noexcept && !uses_strings && !returns_ownership) {
+        attrs.push_back("nothrow");
+    }
+
+    if (returns_ownership || function.return_type.is_uptr) {
+        attrs.push_back("warn_unused_result");
+    }
+
+    if (!nonnull.empty()) {
+        attrs.push_back(fmt::format("nonnull({})", ps::join(", ", nonnull)));
+    }
+
+    if (attrs.empty()) {
+        return "";
+    }
+    return fmt::format("CPPMM_ATTRIBUTES({}) ", ps::join(", ", attrs));
+}
+
+bool is_batch_element(const QualifiedType& qtype) {
+    if (qtype.is_ptr || qtype.is_uptr || (qtype.is_ref && !qtype.is_const)) {
+        return false;
+    }
+
+    if (const Record* record = qtype.type.var.cast_or_null<Record>()) {
+        return record->kind != RecordKind::OpaquePtr;
+    } else if (qtype.type.var.is<Enum>()) {
+        return true;
+    }
+
+    return qtype.type.var.is<Builtin>() && qtype.type.name != "void" &&
+           qtype.type.name.find('*') == std::string::npos;
+}
+
+bool Function::can_batch() const {
+    for (const auto& p : params) {
+        if (!is_batch_element(p.qtype)) {
+            return false;
+        }
+    }
+
+    return return_type.type.name == "void" || is_batch_element(return_type);
+}
+
+std::vector<std::string>
+get_batch_param_declarations(const Function& function) {
+    std::vector<std::string> param_decls;
+    for (const auto& p : function.params) {
+        QualifiedType element = p.qtype;
+        element.is_ref = false;
+        element.is_const = false;
+        param_decls.push_back(fmt::format(
+            "const {}* {}", element.create_c_declaration(), p.name));
+    }
+
+    if (function.return_type.type.name != "void") {
+        QualifiedType element = function.return_type;
+        element.is_ref = false;
+        element.is_const = false;
+        param_decls.push_back(
+            fmt::format("{}* _result", element.create_c_declaration()));
+    }
+
+    param_decls.push_back("size_t _count");
+    return param_decls;
+}
+
+std::string get_batch_body(const Function& function,
+                           const std::string& call_prefix) {
+    // everything is indexed straight out of the arrays and records are
+    // accessed in place rather than bit_cast, so that the callee can be
+    // inlined into the loop and the loop vectorized
+    std::vector<std::string> call_params;
+    for (const auto& p : function.params) {
+        if (p.qtype.type.var.is<Record>()) {
+            call_params.push_back(fmt::format("*to_cpp({} + _i)", p.name));
+        } else if (const Enum* enm = p.qtype.type.var.cast_or_null<Enum>()) {
+            call_params.push_back(
+                fmt::format("({}){}[_i]", enm->cpp_qname, p.name));
+        } else {
+            call_params.push_back(fmt::format("{}[_i]", p.name));
+        }
+    }
+
+    const std::string call =
+        fmt::format("{}({})", call_prefix, ps::join(", ", call_params));
+
+    std::string statement;
+    const TypeVariant& return_var = function.return_type.type.var;
+    if (function.return_type.type.name == "void") {
+        statement = call + ";";
+    } else if (const Record* record = return_var.cast_or_null<Record>()) {
+        statement =
+            fmt::format("new (_result + _i) {}({});", record->cpp_qname, call);
+    } else if (return_var.is<Enum>()) {
+        statement = fmt::format("_result[_i] = (int){};", call);
+    } else {
+        statement = fmt::format("_result[_i] = {};", call);
+    }
+
+    return fmt::format(R"#(    for (size_t _i = 0; _i < _count; ++_i) {{
+        {}
+    }})#",
+                       statement);
+}
+
+std::string Function::get_batch_declaration() const {
+    return fmt::format("void {}_batch({})", c_qname,
+                       ps::join(", ", get_batch_param_declarations(*this)));
+}
+
+std::string
+Function::get_batch_definition(const std::string& declaration) const {
+    return fmt::format(
+        "{} {{\n{}\n}}", declaration,
+        get_exception_safe_body(*this, declaration,
+                                get_batch_body(*this, cpp_qname)));
+}
+
+std::string
+get_return_string_view_body(const Function& function,
+                            const std::string& call_prefix,
+                            const std::vector<std::string>& call_params) {
+    // hand back the pointer and length of whatever the function returned.
+    // auto&& binds to both a returned string_view and a returned string ref
+    // without copying either
+    return fmt::format(R"#(    auto&& result = {}({});
+    return cppmm_string_view{{result.data(), result.size()}};)#",
+                       call_prefix, ps::join(", ", call_params));
+}
+
+std::string
+get_return_string_owned_body(const Function& function,
+                             const std::string& call_prefix,
+                             const std::vector<std::string>& call_params) {
+    // move the returned string straight into the caller's storage. It stays
+    // there until the caller calls cppmm_string_dtor() on it
+    return fmt::format("    new (_result) std::string({}({}));", call_prefix,
+                       ps::join(", ", call_params));
 }
 
 std::string
@@ -114,6 +536,18 @@ get_return_string_copy_body(const Function& function,
                        call_prefix, ps::join(", ", call_params));
 }
 
+std::string
+get_return_out_param_body(const Function& function,
+                          const std::string& call_prefix,
+                          const std::vector<std::string>& call_params) {
+    // construct the returned object directly in the caller's storage. The
+    // returned temporary is elided (or at worst moved) into it, and there is
+    // no second C-side copy to return
+    return fmt::format("    new (_result) {}({}({}));",
+                       function.return_type.type.get_cpp_qname(), call_prefix,
+                       ps::join(", ", call_params));
+}
+
 std::string
 get_return_valuetype_body(const Function& function,
                           const std::string& call_prefix,
@@ -142,12 +576,24 @@ get_return_opaquebytes_body(const Function& function,
                        function.return_type.type.get_c_qname());
 }
 
+std::string
+get_return_map_reference_body(const Function& function,
+                              const std::string& call_prefix,
+                              const std::vector<std::string>& call_params) {
+    // hand back a pointer to the live container, since maps can't be moved
+    // to the caller bytewise. By-value returns go through
+    // get_return_out_param_body() instead
+    return fmt::format("    return to_c({}{}({}));",
+                       function.return_type.is_ref ? "&" : "", call_prefix,
+                       ps::join(", ", call_params));
+}
+
 std::string
 get_return_opaqueptr_body(const Function& function,
                           const std::string& call_prefix,
                           const std::vector<std::string>& call_params) {
-    // Just cast the pointer.
-    // FIXME: what if the function returns an opaqueptr type on the stack?
+    // Just cast the pointer. OpaquePtr types returned by value go through
+    // get_return_out_param_body() instead
     return fmt::format("    return to_c({}({}));", call_prefix,
                        ps::join(", ", call_params));
 }
@@ -21,14 +21,105 @@ struct Function {
     std::string comment;
     std::string cpp_qname;
     std::string c_qname;
+    // generate an array-at-a-time _batch variant as well (cppmm:batch)
+    bool is_batch = false;
+    bool is_noexcept = false;
+    bool is_constexpr = false;
+    // C initializer for the value this function returns, if it could be
+    // evaluated when generating (-constant-values)
+    std::string constant_value;
 
     std::string
     get_declaration(std::set<std::string>& includes,
                     std::set<std::string>& casts_macro_invocations) const;
 
     std::string get_definition(const std::string& declaration) const;
+
+    // Can every parameter and the return value be passed through arrays
+    bool can_batch() const;
+    std::string get_batch_declaration() const;
+    std::string get_batch_definition(const std::string& declaration) const;
 };
 
+// Wrap body, the body of the definition of function, in a try/catch that
+// records any exception with cppmm_set_error_from_current_exception() and
+// returns a zero value. Returns body unchanged if -catch-exceptions is off
+// or the function is noexcept, so those keep a plain forwarding call
+std::string get_exception_safe_body(const Function& function,
+                                    const std::string& declaration,
+                                    const std::string& body);
+
+// Add the includes and casts needed by a callback's parameters and return
+void insert_func_proto_includes(const FuncProto& fp,
+                                std::set<std::string>& includes,
+                                std::set<std::string>& casts_macro_invocations);
+
+// Add the includes and casts needed by a span's element type
+void insert_span_includes(const Span& span, std::set<std::string>& includes,
+                          std::set<std::string>& casts_macro_invocations);
+
+// Add the includes and casts needed to use a map handle
+void insert_map_includes(const Map& map, std::set<std::string>& includes,
+                         std::set<std::string>& casts_macro_invocations);
+
+// Add the includes and casts needed by an optional or variant's alternatives
+void insert_sum_type_includes(const SumType& sum,
+                              std::set<std::string>& includes,
+                              std::set<std::string>& casts_macro_invocations);
+
+// Get the guarded typedefs for any callbacks function takes and for the
+// optional or variant it returns
+std::string get_guarded_type_declarations(const Function& function);
+
+// Get the declaration of a static const <c_qname>_value holding the result of
+// function, or an empty string if it has no constant value
+std::string get_constant_declaration(const Function& function);
+
+// Get the CPPMM_ATTRIBUTES() for the declaration of function, or an empty
+// string if -c-attributes is off or there are none. has_self is whether the C
+// function takes a self pointer first, and returns_ownership whether its
+// result has to be freed by the caller
+std::string get_c_attributes(const Function& function, bool has_self,
+                             bool self_const, bool returns_ownership);
+
+// Can a value of this type be passed element-wise through an array in a
+// _batch variant, i.e. is it a builtin, an enum or a record we can copy
+bool is_batch_element(const QualifiedType& qtype);
+
+// Get the parameter declarations of the _batch variant of function: one array
+// per parameter, an array for the results (if any) and the element count
+std::vector<std::string>
+get_batch_param_declarations(const Function& function);
+
+// Get the loop calling call_prefix once for every element of the arrays
+std::string get_batch_body(const Function& function,
+                           const std::string& call_prefix);
+
+// Add the includes and casts needed to pass a shared_ptr handle
+void insert_shared_ptr_includes(const SharedPtr& sptr,
+                                std::set<std::string>& includes,
+                                std::set<std::string>& casts_macro_invocations);
+
+// Is this one of the string_view types we treat as a (pointer, length) pair
+bool is_string_view(const QualifiedType& qtype);
+
+// Is a by-value return of this type constructed in storage provided by the
+// caller (through a _result out parameter) instead of returned
+bool is_out_param_return(const QualifiedType& return_type);
+
+// Get the C return type for a function returning return_type, appending any
+// out parameters the lowering needs to param_decls
+std::string get_c_return_declaration(const QualifiedType& return_type,
+                                     std::vector<std::string>& param_decls);
+
+std::string
+get_return_string_view_body(const Function& function, const std::string& call_prefix,
+                            const std::vector<std::string>& call_params);
+
+std::string
+get_return_string_owned_body(const Function& function, const std::string& call_prefix,
+                             const std::vector<std::string>& call_params);
+
 std::string
 get_return_string_ref_body(const Function& function, const std::string& call_prefix,
                            const std::vector<std::string>& call_params);
@@ -37,6 +128,10 @@ std::string
 get_return_string_copy_body(const Function& function, const std::string& call_prefix,
                             const std::vector<std::string>& call_params);
 
+std::string
+get_return_out_param_body(const Function& function, const std::string& call_prefix,
+                          const std::vector<std::string>& call_params);
+
 std::string
 get_return_valuetype_body(const Function& function, const std::string& call_prefix,
                           const std::vector<std::string>& call_params);
@@ -49,6 +144,10 @@ std::string
 get_return_opaqueptr_body(const Function& function, const std::string& call_prefix,
                           const std::vector<std::string>& call_params);
 
+std::string
+get_return_map_reference_body(const Function& function, const std::string& call_prefix,
+                              const std::vector<std::string>& call_params);
+
 std::string
 get_return_uniqueptr_body(const Function& function, const std::string& call_prefix,
                           const std::vector<std::string>& call_params);
@@ -1,5 +1,6 @@
 #include "generator_c.hpp"
 #include "filesystem.hpp"
+#include "options.hpp"
 #include "pystring.h"
 
 namespace cppmm {
@@ -14,6 +15,83 @@ std::string bind_file_root(const std::string& filename) {
     return root;
 }
 
+// Prefix for every generated C declaration. Only non-empty when we're building
+// a shared library, where everything is hidden by default and the entry points
+// are exported explicitly.
+std::string get_export_prefix() {
+    if (options.shared) {
+        return "CPPMM_API ";
+    }
+    return "";
+}
+
+std::string get_export_macro_definition() {
+    if (!options.shared) {
+        return "";
+    }
+
+    return R"#(
+#if defined(_WIN32) || defined(__CYGWIN__)
+#ifdef CPPMM_EXPORTS
+#define CPPMM_API __declspec(dllexport)
+#else
+#define CPPMM_API __declspec(dllimport)
+#endif
+#else
+#define CPPMM_API __attribute__((visibility("default")))
+#endif
+)#";
+}
+
+// CPPMM_ATTRIBUTES is guarded rather than undefined at the end of the header,
+// since every generated header defines it
+std::string get_attribute_macro_definitions() {
+    if (!options.c_attributes) {
+        return "";
+    }
+
+    return R"#(
+#ifndef CPPMM_ATTRIBUTES
+#if defined(__GNUC__) || defined(__clang__)
+#define CPPMM_ATTRIBUTES(...) __attribute__((__VA_ARGS__))
+#else
+#define CPPMM_ATTRIBUTES(...)
+#endif
+#endif
+)#";
+}
+
+std::string get_export_macro_undef() {
+    if (!options.shared) {
+        return "";
+    }
+    return "#undef CPPMM_API\n";
+}
+
+// Prefix for the wrapper definitions in the implementation. With -lto the
+// library is bitcode, and forcing the (mostly trivial) forwarders inline lets
+// the caller's LTO link fold them away instead of paying a call into C++
+std::string get_lto_inline_prefix() {
+    if (options.lto) {
+        return "CPPMM_LTO_INLINE ";
+    }
+    return "";
+}
+
+std::string get_lto_macro_definition() {
+    if (!options.lto) {
+        return "";
+    }
+
+    return R"#(
+#if defined(__clang__)
+#define CPPMM_LTO_INLINE __attribute__((always_inline))
+#else
+#define CPPMM_LTO_INLINE
+#endif
+)#";
+}
+
 void write_header(const std::string& filename, const std::string& declarations,
                   const std::string& include_stmts) {
 
@@ -33,16 +111,18 @@ extern "C" {{
 #else
 #define CPPMM_ALIGN(x) __attribute__((aligned(x)))
 #endif
-
+{}
 {}
 
 #undef CPPMM_ALIGN
-
+{}
 #ifdef __cplusplus
 }}
 #endif
     )#",
-        include_stmts, declarations);
+        include_stmts,
+        get_export_macro_definition() + get_attribute_macro_definitions(),
+        declarations, get_export_macro_undef());
 
     auto out = fopen(filename.c_str(), "w");
     fprintf(out, "%s", out_str.c_str());
@@ -57,6 +137,7 @@ void write_implementation(const std::string& filename, const std::string& root,
         R"#(//
 #include "{}.h"
 {}
+#include <algorithm>
 
 namespace {{
 #include "casts.h"
@@ -64,12 +145,13 @@ namespace {{
 {}
 #undef CPPMM_DEFINE_POINTER_CASTS
 }}
-
+{}
 extern "C" {{
 {}
 }}
     )#",
-        root, ps::join("\n", includes), casts, definitions);
+        root, ps::join("\n", includes), casts, get_lto_macro_definition(),
+        definitions);
 
     auto out = fopen(filename.c_str(), "w");
     fprintf(out, "%s", out_str.c_str());
@@ -121,38 +203,100 @@ void safe_strcpy(char* dst, const std::string& str, int buffer_size) {
     fclose(out);
 }
 
+bool has_opaqueptr_elements(const cppmm::Vector& vec) {
+    return vec.element_type.type.var.is<Record>() &&
+           vec.element_type.type.var.cast<Record>()->kind ==
+               RecordKind::OpaquePtr;
+}
+
+// Can the elements be copied with memcpy and default constructed by resize()?
+// That's builtins and valuetypes, and opaquebytes records that are trivial in
+// C++
+bool has_trivial_elements(const cppmm::Vector& vec) {
+    if (const Record* record =
+            vec.element_type.type.var.cast_or_null<Record>()) {
+        return record->kind == RecordKind::ValueType || record->is_trivial;
+    }
+    return true;
+}
+
 std::string get_vector_declaration(const cppmm::Vector& vec) {
     std::string format_str =
         R"#(
 typedef struct {{ char _private[24]; }} {0} CPPMM_ALIGN(8);
 
-void {0}_ctor({0}* vec);
-void {0}_dtor(const {0}* vec);
-int {0}_size(const {0}* vec);
-{1}* {0}_data({0}* vec);
+{2}void {0}_ctor({0}* vec);
+{2}void {0}_dtor(const {0}* vec);
+{2}int {0}_size(const {0}* vec);
+{2}{1}* {0}_data({0}* vec);
+)#";
+
+    if (has_opaqueptr_elements(vec)) {
+        format_str +=
+            R"#(
+{2}void {0}_get(const {0}* vec, int index, {1}** element);
+{2}void {0}_set({0}* vec, int index, {1}* element);
+
+{2}void {0}_reserve({0}* vec, size_t n);
+{2}void {0}_clear({0}* vec);
+{2}void {0}_push_back({0}* vec, const {1}* element);
+{2}size_t {0}_copy_to(const {0}* vec, {1}* const* dst, size_t n);
+{2}void {0}_copy_from({0}* vec, const {1}* const* src, size_t n);
+{2}void {0}_assign_range({0}* vec, size_t offset, const {1}* const* src, size_t n);
 )#";
 
-    if (vec.element_type.type.var.is<Record>() &&
-        vec.element_type.type.var.cast<Record>()->kind ==
-            RecordKind::OpaquePtr) {
+    } else if (!has_trivial_elements(vec)) {
         format_str +=
             R"#(
-void {0}_get(const {0}* vec, int index, {1}** element);
-void {0}_set({0}* vec, int index, {1}* element);
+{2}void {0}_get(const {0}* vec, int index, {1}* element);
+{2}void {0}_set({0}* vec, int index, {1}* element);
+
+{2}void {0}_reserve({0}* vec, size_t n);
+{2}void {0}_clear({0}* vec);
+{2}void {0}_push_back({0}* vec, const {1}* element);
+{2}size_t {0}_copy_to(const {0}* vec, {1}* dst, size_t n);
+{2}void {0}_copy_from({0}* vec, const {1}* src, size_t n);
+{2}void {0}_assign_range({0}* vec, size_t offset, const {1}* src, size_t n);
 )#";
 
     } else {
         format_str +=
             R"#(
-void {0}_get(const {0}* vec, int index, {1}* element);
-void {0}_set({0}* vec, int index, {1}* element);
+{2}void {0}_get(const {0}* vec, int index, {1}* element);
+{2}void {0}_set({0}* vec, int index, {1}* element);
+
+{2}void {0}_reserve({0}* vec, size_t n);
+{2}void {0}_resize({0}* vec, size_t n);
+{2}void {0}_clear({0}* vec);
+{2}void {0}_push_back({0}* vec, const {1}* element);
+{2}size_t {0}_copy_to(const {0}* vec, {1}* dst, size_t n);
+{2}void {0}_copy_from({0}* vec, const {1}* src, size_t n);
+{2}void {0}_assign_range({0}* vec, size_t offset, const {1}* src, size_t n);
 )#";
     }
 
     return fmt::format(format_str, vec.c_qname,
-                       vec.element_type.type.get_c_qname());
+                       vec.element_type.type.get_c_qname(),
+                       get_export_prefix());
 } // namespace cppmm
 
+// Names of all the functions declared by get_vector_declaration(), for the
+// export list
+std::vector<std::string> get_vector_symbols(const cppmm::Vector& vec) {
+    std::vector<std::string> suffixes = {
+        "ctor",    "dtor",  "size",      "data",    "get",       "set",
+        "reserve", "clear", "push_back", "copy_to", "copy_from", "assign_range"};
+    if (!has_opaqueptr_elements(vec) && has_trivial_elements(vec)) {
+        suffixes.push_back("resize");
+    }
+
+    std::vector<std::string> result;
+    for (const auto& suffix : suffixes) {
+        result.push_back(fmt::format("{}_{}", vec.c_qname, suffix));
+    }
+    return result;
+}
+
 std::string
 get_vector_implementation(const cppmm::Vector& vec,
                           std::set<std::string>& casts_macro_invocations) {
@@ -183,9 +327,10 @@ int {0}_size(const {0}* vec) {{
 }}
 )#";
 
-    if (vec.element_type.type.var.is<Record>() &&
-        vec.element_type.type.var.cast<Record>()->kind ==
-            RecordKind::OpaquePtr) {
+    if (has_opaqueptr_elements(vec)) {
+        // OpaquePtr elements can't be memcpy'd and might not be default
+        // constructible, so the bulk functions copy element by element from
+        // arrays of pointers, and we don't provide resize
         format_str +=
             R"#(
 void {0}_get(const {0}* vec, int index, {1}** element) {{
@@ -197,9 +342,103 @@ void {0}_get(const {0}* vec, int index, {1}** element) {{
 void {0}_set({0}* vec, int index, {1}* element) {{
     (*to_cpp(vec))[index] = *to_cpp(element);
 }}
+
+void {0}_reserve({0}* vec, size_t n) {{
+    to_cpp(vec)->reserve(n);
+}}
+
+void {0}_clear({0}* vec) {{
+    to_cpp(vec)->clear();
+}}
+
+void {0}_push_back({0}* vec, const {1}* element) {{
+    to_cpp(vec)->push_back(*to_cpp(element));
+}}
+
+size_t {0}_copy_to(const {0}* vec, {1}* const* dst, size_t n) {{
+    const std::vector<{2}>& v = *to_cpp(vec);
+    const size_t count = std::min(n, v.size());
+    for (size_t i = 0; i < count; ++i) {{
+        *to_cpp(dst[i]) = v[i];
+    }}
+    return count;
+}}
+
+void {0}_copy_from({0}* vec, const {1}* const* src, size_t n) {{
+    std::vector<{2}>& v = *to_cpp(vec);
+    v.clear();
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {{
+        v.push_back(*to_cpp(src[i]));
+    }}
+}}
+
+void {0}_assign_range({0}* vec, size_t offset, const {1}* const* src, size_t n) {{
+    std::vector<{2}>& v = *to_cpp(vec);
+    for (size_t i = 0; i < n; ++i) {{
+        if (offset + i < v.size()) {{
+            v[offset + i] = *to_cpp(src[i]);
+        }} else {{
+            v.push_back(*to_cpp(src[i]));
+        }}
+    }}
+}}
+)#";
+
+    } else if (!has_trivial_elements(vec)) {
+        // Opaquebytes records that aren't trivial may need their copy
+        // constructor and assignment run, and might not be default
+        // constructible, so these copy element by element from arrays of
+        // values, and we don't provide resize
+        format_str +=
+            R"#(
+void {0}_get(const {0}* vec, int index, {1}* element) {{
+    *to_cpp(element) = (*to_cpp(vec))[index];
+}}
+
+void {0}_set({0}* vec, int index, {1}* element) {{
+    (*to_cpp(vec))[index] = *to_cpp(element);
+}}
+
+void {0}_reserve({0}* vec, size_t n) {{
+    to_cpp(vec)->reserve(n);
+}}
+
+void {0}_clear({0}* vec) {{
+    to_cpp(vec)->clear();
+}}
+
+void {0}_push_back({0}* vec, const {1}* element) {{
+    to_cpp(vec)->push_back(*to_cpp(element));
+}}
+
+size_t {0}_copy_to(const {0}* vec, {1}* dst, size_t n) {{
+    const std::vector<{2}>& v = *to_cpp(vec);
+    const size_t count = std::min(n, v.size());
+    std::copy(v.begin(), v.begin() + count, to_cpp(dst));
+    return count;
+}}
+
+void {0}_copy_from({0}* vec, const {1}* src, size_t n) {{
+    to_cpp(vec)->assign(to_cpp(src), to_cpp(src) + n);
+}}
+
+void {0}_assign_range({0}* vec, size_t offset, const {1}* src, size_t n) {{
+    std::vector<{2}>& v = *to_cpp(vec);
+    for (size_t i = 0; i < n; ++i) {{
+        if (offset + i < v.size()) {{
+            v[offset + i] = to_cpp(src)[i];
+        }} else {{
+            v.push_back(to_cpp(src)[i]);
+        }}
+    }}
+}}
 )#";
 
     } else {
+        // Everything else is trivial, so the bulk functions reduce to a
+        // single memcpy (or the memmove that assign() does for trivially
+        // copyable types)
         format_str +=
             R"#(
 void {0}_get(const {0}* vec, int index, {1}* element) {{
@@ -211,6 +450,41 @@ void {0}_get(const {0}* vec, int index, {1}* element) {{
 void {0}_set({0}* vec, int index, {1}* element) {{
     (*to_cpp(vec))[index] = *to_cpp(element);
 }}
+
+void {0}_reserve({0}* vec, size_t n) {{
+    to_cpp(vec)->reserve(n);
+}}
+
+void {0}_resize({0}* vec, size_t n) {{
+    to_cpp(vec)->resize(n);
+}}
+
+void {0}_clear({0}* vec) {{
+    to_cpp(vec)->clear();
+}}
+
+void {0}_push_back({0}* vec, const {1}* element) {{
+    to_cpp(vec)->push_back(*to_cpp(element));
+}}
+
+size_t {0}_copy_to(const {0}* vec, {1}* dst, size_t n) {{
+    const std::vector<{2}>& v = *to_cpp(vec);
+    const size_t count = std::min(n, v.size());
+    memcpy((void*)dst, (const void*)v.data(), count * sizeof({2}));
+    return count;
+}}
+
+void {0}_copy_from({0}* vec, const {1}* src, size_t n) {{
+    to_cpp(vec)->assign(to_cpp(src), to_cpp(src) + n);
+}}
+
+void {0}_assign_range({0}* vec, size_t offset, const {1}* src, size_t n) {{
+    std::vector<{2}>& v = *to_cpp(vec);
+    if (v.size() < offset + n) {{
+        v.resize(offset + n);
+    }}
+    memcpy((void*)(v.data() + offset), (const void*)src, n * sizeof({2}));
+}}
 )#";
     }
 
@@ -221,11 +495,640 @@ void {0}_set({0}* vec, int index, {1}* element) {{
         vec.element_type.type.get_cpp_qname()); //< 2: C++ element
 }
 
-void write_containers_header(const std::string& filename) {
-    const std::string header = R"#(
+// Records are emitted in the order of the file's record map, except that the
+// records a valuetype holds by value have to be declared before it
+void order_records(const std::string& c_qname, const ExportedFile& ex_file,
+                   const RecordMap& records, std::set<std::string>& visited,
+                   std::vector<std::string>& order) {
+    if (!visited.insert(c_qname).second) {
+        return;
+    }
+
+    const auto it_record = records.find(c_qname);
+    if (it_record != records.end()) {
+        // valuetypes hold their field records inline, and field accessors
+        // pass them by value, so either way they must be declared first
+        const auto& fields = it_record->second.kind == RecordKind::ValueType
+                                 ? it_record->second.fields
+                                 : it_record->second.accessor_fields;
+        for (const auto& field : fields) {
+            const Record* field_record =
+                field.qtype.type.var.cast_or_null<Record>();
+            if (field_record && !field.qtype.is_ptr &&
+                ex_file.records.find(field_record->c_qname) !=
+                    ex_file.records.end()) {
+                order_records(field_record->c_qname, ex_file, records, visited,
+                              order);
+            }
+        }
+    }
+
+    order.push_back(c_qname);
+}
+
+// A shared_ptr is two pointers on every ABI we care about, so the handle is
+// stored inline in the caller's memory like a vector. _retain() copies it
+// (bumping the refcount) into another handle, _release() destroys it in place
+std::string get_shared_ptr_declaration(const cppmm::SharedPtr& sptr) {
+    return fmt::format(R"#(
+typedef struct {{ char _private[16]; }} {0} CPPMM_ALIGN(8);
+
+{2}void {0}_retain(const {0}* ptr, {0}* copy);
+{2}void {0}_release({0}* ptr);
+{2}{1}* {0}_get(const {0}* ptr);
+{2}long {0}_use_count(const {0}* ptr);
+)#",
+                       sptr.c_qname, sptr.element_type.type.get_c_qname(),
+                       get_export_prefix());
+}
+
+std::vector<std::string>
+get_shared_ptr_symbols(const cppmm::SharedPtr& sptr) {
+    std::vector<std::string> result;
+    for (const char* suffix : {"retain", "release", "get", "use_count"}) {
+        result.push_back(fmt::format("{}_{}", sptr.c_qname, suffix));
+    }
+    return result;
+}
+
+std::string
+get_shared_ptr_implementation(const cppmm::SharedPtr& sptr,
+                              std::set<std::string>& casts_macro_invocations) {
+    casts_macro_invocations.insert(sptr.create_casts());
+    if (const cppmm::Record* record =
+            sptr.element_type.type.var.cast_or_null<cppmm::Record>()) {
+        casts_macro_invocations.insert(record->create_casts());
+    }
+
+    return fmt::format(R"#(
+static_assert(sizeof(std::shared_ptr<{2}>) == sizeof({0}), "sizes do not match");
+static_assert(alignof(std::shared_ptr<{2}>) == alignof({0}), "alignments do not match");
+
+void {0}_retain(const {0}* ptr, {0}* copy) {{
+    new (copy) std::shared_ptr<{2}>(*to_cpp(ptr));
+}}
+
+void {0}_release({0}* ptr) {{
+    to_cpp(ptr)->~shared_ptr();
+}}
+
+{1}* {0}_get(const {0}* ptr) {{
+    return to_c(to_cpp(ptr)->get());
+}}
+
+long {0}_use_count(const {0}* ptr) {{
+    return to_cpp(ptr)->use_count();
+}}
+)#",
+                       sptr.c_qname, sptr.element_type.type.get_c_qname(),
+                       sptr.element_type.type.get_cpp_qname());
+}
+
+// C type a map's key or value is read as. Everything except strings is
+// returned as a pointer into the container, so enums are read as their
+// underlying type rather than the int they're passed as elsewhere
+std::string get_map_element_c_type(const QualifiedType& qtype) {
+    if (qtype.type.name == "basic_string") {
+        return "cppmm_string_view";
+    } else if (const Enum* enm = qtype.type.var.cast_or_null<Enum>()) {
+        return fmt::format("const {}*", enm->underlying_type);
+    }
+    return fmt::format("const {}*", qtype.type.get_c_qname());
+}
+
+std::string get_map_element_access(const QualifiedType& qtype,
+                                   const std::string& expr) {
+    if (qtype.type.name == "basic_string") {
+        return fmt::format(R"#(    const std::string& s = {};
+    return cppmm_string_view{{s.data(), s.size()}};)#",
+                           expr);
+    } else if (const Enum* enm = qtype.type.var.cast_or_null<Enum>()) {
+        return fmt::format("    return reinterpret_cast<const {}*>(&{});",
+                           enm->underlying_type, expr);
+    } else if (qtype.type.var.is<Record>()) {
+        return fmt::format("    return to_c(&{});", expr);
+    }
+    return fmt::format("    return &{};", expr);
+}
+
+std::string get_map_key_declaration(const QualifiedType& key_type) {
+    if (key_type.type.name == "basic_string") {
+        return "const char* key, size_t key_len";
+    } else if (key_type.type.var.is<Enum>()) {
+        return "int key";
+    } else if (key_type.type.var.is<Record>()) {
+        return fmt::format("const {}* key", key_type.type.get_c_qname());
+    }
+    return fmt::format("{} key", key_type.type.get_c_qname());
+}
+
+std::string get_map_key_call(const QualifiedType& key_type) {
+    if (key_type.type.name == "basic_string") {
+        return "std::string(key, key_len)";
+    } else if (key_type.type.var.is<Enum>()) {
+        return fmt::format("({})key", key_type.type.get_cpp_qname());
+    } else if (key_type.type.var.is<Record>()) {
+        return "*to_cpp(key)";
+    }
+    return "key";
+}
+
+// Maps and sets are stored inline in the caller's memory like vectors, sized
+// for the largest of the standard library implementations. Unlike vectors the
+// handles can't be copied or moved with struct assignment or memcpy, since the
+// containers may point back into themselves, so they must be constructed where
+// they'll live and returned maps always go through a _result out parameter.
+// Elements are read through a cursor holding a const_iterator: _begin() and
+// _find() set it and _next() advances it, and all three return false when
+// there's no element, so a whole map is read with
+//     for (bool ok = m_begin(map, &c); ok; ok = m_next(map, &c)) { ... }
+std::string get_map_declaration(const cppmm::Map& map) {
+    std::string result = fmt::format(
+        R"#(
+// Must stay where it was constructed: don't copy or move it with struct
+// assignment or memcpy
+typedef struct {{ char _private[64]; }} {0} CPPMM_ALIGN(8);
+// A position in a {0}. Only valid until the container is modified
+typedef struct {{ char _private[16]; }} {0}_cursor CPPMM_ALIGN(8);
+
+{1}void {0}_ctor({0}* map);
+{1}void {0}_dtor(const {0}* map);
+{1}size_t {0}_size(const {0}* map);
+{1}bool {0}_find(const {0}* map, {2}, {0}_cursor* cursor);
+{1}bool {0}_begin(const {0}* map, {0}_cursor* cursor);
+{1}bool {0}_next(const {0}* map, {0}_cursor* cursor);
+{1}{3} {0}_key(const {0}_cursor* cursor);
+)#",
+        map.c_qname, get_export_prefix(), get_map_key_declaration(map.key_type),
+        get_map_element_c_type(map.key_type));
+
+    if (!map.is_set) {
+        result += fmt::format("{}{} {}_value(const {}_cursor* cursor);\n",
+                              get_export_prefix(),
+                              get_map_element_c_type(map.value_type),
+                              map.c_qname, map.c_qname);
+    }
+    return result;
+}
+
+std::vector<std::string> get_map_symbols(const cppmm::Map& map) {
+    std::vector<std::string> suffixes = {"ctor",  "dtor", "size", "find",
+                                         "begin", "next", "key"};
+    if (!map.is_set) {
+        suffixes.push_back("value");
+    }
+
+    std::vector<std::string> result;
+    for (const auto& suffix : suffixes) {
+        result.push_back(fmt::format("{}_{}", map.c_qname, suffix));
+    }
+    return result;
+}
+
+std::string
+get_map_implementation(const cppmm::Map& map,
+                       std::set<std::string>& casts_macro_invocations) {
+    casts_macro_invocations.insert(map.create_casts());
+    for (const auto* qtype : {&map.key_type, &map.value_type}) {
+        if (const cppmm::Record* record =
+                qtype->type.var.cast_or_null<cppmm::Record>()) {
+            casts_macro_invocations.insert(record->create_casts());
+        }
+    }
+
+    std::string result = fmt::format(
+        R"#(
+static_assert(sizeof({0}_type) <= sizeof({0}), "{0} is too small");
+static_assert(alignof({0}_type) <= alignof({0}), "{0} is not aligned enough");
+static_assert(sizeof({0}_type::const_iterator) <= sizeof({0}_cursor), "{0}_cursor is too small");
+
+void {0}_ctor({0}* map) {{
+    new (map) {0}_type();
+}}
+
+void {0}_dtor(const {0}* map) {{
+    to_cpp(map)->~{0}_type();
+}}
+
+size_t {0}_size(const {0}* map) {{
+    return to_cpp(map)->size();
+}}
+
+bool {0}_find(const {0}* map, {1}, {0}_cursor* cursor) {{
+    const {0}_type& m = *to_cpp(map);
+    {0}_type::const_iterator it = m.find({2});
+    if (it == m.end()) {{
+        return false;
+    }}
+    new (cursor) {0}_type::const_iterator(it);
+    return true;
+}}
+
+bool {0}_begin(const {0}* map, {0}_cursor* cursor) {{
+    const {0}_type& m = *to_cpp(map);
+    if (m.empty()) {{
+        return false;
+    }}
+    new (cursor) {0}_type::const_iterator(m.begin());
+    return true;
+}}
+
+bool {0}_next(const {0}* map, {0}_cursor* cursor) {{
+    {0}_type::const_iterator& it =
+        *reinterpret_cast<{0}_type::const_iterator*>(cursor);
+    return ++it != to_cpp(map)->end();
+}}
+
+{3} {0}_key(const {0}_cursor* cursor) {{
+    const {0}_type::const_iterator& it =
+        *reinterpret_cast<const {0}_type::const_iterator*>(cursor);
+{4}
+}}
+)#",
+        map.c_qname, get_map_key_declaration(map.key_type),
+        get_map_key_call(map.key_type), get_map_element_c_type(map.key_type),
+        get_map_element_access(map.key_type, map.is_set ? "*it" : "it->first"));
+
+    if (!map.is_set) {
+        result += fmt::format(
+            R"#(
+{1} {0}_value(const {0}_cursor* cursor) {{
+    const {0}_type::const_iterator& it =
+        *reinterpret_cast<const {0}_type::const_iterator*>(cursor);
+{2}
+}}
+)#",
+            map.c_qname, get_map_element_c_type(map.value_type),
+            get_map_element_access(map.value_type, "it->second"));
+    }
+    return result;
+}
+
+// Maps with no record to be declared alongside, sorted so the output is
+// stable, or those whose home record is record if it isn't null
+std::vector<const cppmm::Map*> get_home_maps(const MapMap& maps,
+                                             const Record* record) {
+    std::vector<const cppmm::Map*> result;
+    for (const auto& map_pair : maps) {
+        const Record* home = map_pair.second.get_home_record();
+        if ((home == nullptr && record == nullptr) ||
+            (home != nullptr && record != nullptr &&
+             home->c_qname == record->c_qname)) {
+            result.push_back(&map_pair.second);
+        }
+    }
+    std::sort(result.begin(), result.end(),
+              [](const cppmm::Map* a, const cppmm::Map* b) {
+                  return a->c_qname < b->c_qname;
+              });
+    return result;
+}
+
+// Is record handed out by the library itself, as a unique_ptr or raw pointer
+// return, and so allocated with new rather than through cppmm_allocate()?
+bool is_returned_as_pointer(const cppmm::Record& record, const FileMap& files,
+                            const RecordMap& records) {
+    auto returns_record = [&record](const Function& function) {
+        const Record* returned =
+            function.return_type.type.var.cast_or_null<Record>();
+        return returned != nullptr && returned->c_qname == record.c_qname &&
+               (function.return_type.is_uptr || function.return_type.is_ptr);
+    };
+
+    for (const auto& file_pair : files) {
+        for (const auto& function_pair : file_pair.second.functions) {
+            if (returns_record(function_pair.second)) {
+                return true;
+            }
+        }
+    }
+    for (const auto& record_pair : records) {
+        for (const auto& method_pair : record_pair.second.methods) {
+            if (returns_record(method_pair.second)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Does record have a bound constructor, which allocates through
+// cppmm_allocate()?
+bool has_allocating_constructor(const cppmm::Record& record) {
+    for (const auto& method_pair : record.methods) {
+        if (method_pair.second.is_constructor) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every OpaquePtr record gets its size and alignment, and a way to destroy it
+// without freeing, so that callers can construct it in their own storage with
+// the _at() constructor variants. _destroy() is the counterpart of the
+// allocating constructors and hands the memory back to cppmm_deallocate(), so
+// it's only generated when there are any. Objects the library allocated
+// itself and returned by pointer are freed with _free() instead, which goes
+// through the (possibly virtual) destructor and operator delete.
+std::string get_opaqueptr_storage_declaration(const cppmm::Record& record,
+                                              bool has_destroy, bool has_free) {
+    std::string result = fmt::format(R"#({1}size_t {0}_sizeof();
+{1}size_t {0}_alignof();
+{1}void {0}_destruct_at({0}* self);
+)#",
+                                     record.c_qname, get_export_prefix());
+    if (has_destroy) {
+        result += fmt::format("{1}void {0}_destroy({0}* self);\n",
+                              record.c_qname, get_export_prefix());
+    }
+    if (has_free) {
+        result += fmt::format("{1}void {0}_free({0}* self);\n",
+                              record.c_qname, get_export_prefix());
+    }
+    return result + "\n";
+}
+
+std::vector<std::string>
+get_opaqueptr_storage_symbols(const cppmm::Record& record, bool has_destroy,
+                              bool has_free) {
+    std::vector<std::string> result;
+    for (const char* suffix : {"sizeof", "alignof", "destruct_at"}) {
+        result.push_back(fmt::format("{}_{}", record.c_qname, suffix));
+    }
+    if (has_destroy) {
+        result.push_back(record.c_qname + "_destroy");
+    }
+    if (has_free) {
+        result.push_back(record.c_qname + "_free");
+    }
+    return result;
+}
+
+std::string
+get_opaqueptr_storage_implementation(const cppmm::Record& record,
+                                     bool has_destroy, bool has_free) {
+    std::string result = fmt::format(R"#(
+size_t {0}_sizeof() {{
+    return sizeof({1});
+}}
+
+size_t {0}_alignof() {{
+    return alignof({1});
+}}
+
+void {0}_destruct_at({0}* self) {{
+    using T = {1};
+    to_cpp(self)->~T();
+}}
+)#",
+                                     record.c_qname, record.cpp_qname);
+
+    if (has_destroy) {
+        result += fmt::format(R"#(
+void {0}_destroy({0}* self) {{
+    using T = {1};
+    to_cpp(self)->~T();
+    cppmm_deallocate(self, sizeof(T), alignof(T));
+}}
+)#",
+                              record.c_qname, record.cpp_qname);
+    }
+
+    if (has_free) {
+        result += fmt::format(R"#(
+void {0}_free({0}* self) {{
+    delete to_cpp(self);
+}}
+)#",
+                              record.c_qname);
+    }
+    return result + "\n";
+}
+
+// The C type a field is read and written as through its accessors
+std::string get_field_c_type(const QualifiedType& qtype) {
+    if (qtype.type.var.is<Enum>()) {
+        return "int";
+    }
+    return qtype.type.get_c_qname();
+}
+
+std::string get_field_to_c(const QualifiedType& qtype,
+                           const std::string& expr) {
+    if (const Record* record = qtype.type.var.cast_or_null<Record>()) {
+        return fmt::format("bit_cast<{}>({})", record->c_qname, expr);
+    } else if (qtype.type.var.is<Enum>()) {
+        return fmt::format("(int){}", expr);
+    }
+    return expr;
+}
+
+std::string get_field_to_cpp(const QualifiedType& qtype,
+                             const std::string& expr) {
+    if (const Record* record = qtype.type.var.cast_or_null<Record>()) {
+        return fmt::format("bit_cast<{}>({})", record->cpp_qname, expr);
+    } else if (const Enum* enm = qtype.type.var.cast_or_null<Enum>()) {
+        return fmt::format("({}){}", enm->cpp_qname, expr);
+    }
+    return expr;
+}
+
+// With -field-accessors, opaque records get a getter and setter for each of
+// their public fields, and a <record>_fields struct with _snapshot() and
+// _apply() to copy all of them at once, so reading several fields costs one
+// call instead of one each. const fields are read but never written.
+std::string get_field_accessor_declaration(const cppmm::Record& record) {
+    std::string members;
+    std::string accessors;
+    for (const auto& field : record.accessor_fields) {
+        const std::string c_type = get_field_c_type(field.qtype);
+        members += fmt::format("    {} {};\n", c_type, field.name);
+        accessors += fmt::format("{}{} {}_get_{}(const {}* self);\n",
+                                 get_export_prefix(), c_type, record.c_qname,
+                                 field.name, record.c_qname);
+        if (!field.qtype.is_const) {
+            accessors += fmt::format("{}void {}_set_{}({}* self, {} value);\n",
+                                     get_export_prefix(), record.c_qname,
+                                     field.name, record.c_qname, c_type);
+        }
+    }
+
+    return fmt::format(R"#(typedef struct {{
+{2}}} {0}_fields;
+
+{3}{1}void {0}_snapshot(const {0}* self, {0}_fields* out);
+{1}void {0}_apply({0}* self, const {0}_fields* fields);
+
+)#",
+                       record.c_qname, get_export_prefix(), members,
+                       accessors);
+}
+
+std::vector<std::string>
+get_field_accessor_symbols(const cppmm::Record& record) {
+    std::vector<std::string> result;
+    for (const auto& field : record.accessor_fields) {
+        result.push_back(
+            fmt::format("{}_get_{}", record.c_qname, field.name));
+        if (!field.qtype.is_const) {
+            result.push_back(
+                fmt::format("{}_set_{}", record.c_qname, field.name));
+        }
+    }
+    result.push_back(record.c_qname + "_snapshot");
+    result.push_back(record.c_qname + "_apply");
+    return result;
+}
+
+std::string
+get_field_accessor_implementation(const cppmm::Record& record) {
+    std::string result;
+    std::string snapshot;
+    std::string apply;
+    for (const auto& field : record.accessor_fields) {
+        const std::string c_type = get_field_c_type(field.qtype);
+        const std::string cpp_field = "to_cpp(self)->" + field.name;
+        result += fmt::format(R"#(
+{0} {1}_get_{2}(const {1}* self) {{
+    return {3};
+}}
+)#",
+                              c_type, record.c_qname, field.name,
+                              get_field_to_c(field.qtype, cpp_field));
+        snapshot += fmt::format("    out->{} = {};\n", field.name,
+                                get_field_to_c(field.qtype, cpp_field));
+        if (!field.qtype.is_const) {
+            result += fmt::format(R"#(
+void {1}_set_{2}({1}* self, {0} value) {{
+    {3} = {4};
+}}
+)#",
+                                  c_type, record.c_qname, field.name,
+                                  cpp_field,
+                                  get_field_to_cpp(field.qtype, "value"));
+            apply += fmt::format(
+                "    {} = {};\n", cpp_field,
+                get_field_to_cpp(field.qtype, "fields->" + field.name));
+        }
+    }
+
+    result += fmt::format(R"#(
+void {0}_snapshot(const {0}* self, {0}_fields* out) {{
+{1}}}
+
+void {0}_apply({0}* self, const {0}_fields* fields) {{
+{2}}}
+
+)#",
+                          record.c_qname, snapshot, apply);
+    return result;
+}
+
+// Declarations for the thread-local error record that -catch-exceptions
+// reports exceptions through
+std::string get_error_declarations() {
+    if (!options.catch_exceptions) {
+        return "";
+    }
+
+    return fmt::format(R"#(// Error codes for exceptions caught before they reach C
+enum {{
+    CPPMM_ERROR_NONE = 0,
+    CPPMM_ERROR_BAD_ALLOC = 1,
+    CPPMM_ERROR_EXCEPTION = 2,
+    CPPMM_ERROR_UNKNOWN = 3,
+}};
+
+// When a function that is not noexcept throws, the exception is recorded for
+// the calling thread and the function returns a zero value. Successful calls
+// don't reset the record, so clear it before a sequence of calls and check it
+// afterwards. Reading it never allocates, and the message is valid until the
+// next error on the same thread.
+//
+// Only the bound functions are wrapped. The generated helpers (the vector,
+// string vector, map and shared_ptr functions and the field accessors) don't
+// catch anything, so an allocation failure in them still unwinds into C.
+{0}int cppmm_error_code();
+{0}const char* cppmm_error_message();
+{0}void cppmm_clear_error();
+
+#ifdef __cplusplus
+// Records the exception currently being handled. Only for use by the
+// generated wrappers, from inside a catch block
+void cppmm_set_error_from_current_exception();
+#endif
+
+)#",
+                       get_export_prefix());
+}
+
+// Types of the tables -reflection emits for each valuetype and opaquebytes
+// record and each enum
+std::string get_reflection_declarations() {
+    if (!options.reflection) {
+        return "";
+    }
+
+    return R"#(// Reflection tables. Every bound valuetype and opaquebytes record has an
+// extern const cppmm_record_info cppmm_reflect_<record>, and every enum a
+// cppmm_enum_info cppmm_reflect_<enum>, declared in its header and defined
+// once in the library. Offsets and sizes are in bytes, so fields can be read
+// and written directly through memory.
+enum {
+    CPPMM_KIND_BOOL = 0,
+    CPPMM_KIND_INT = 1,
+    CPPMM_KIND_UINT = 2,
+    CPPMM_KIND_FLOAT = 3,
+    CPPMM_KIND_ENUM = 4,
+    CPPMM_KIND_RECORD = 5,
+    CPPMM_KIND_POINTER = 6,
+    // a C++ type with no C representation, such as a std::vector
+    CPPMM_KIND_OTHER = 7,
+};
+
+typedef struct {
+    const char* name;
+    size_t offset;
+    // of the whole field, so for arrays of all count elements
+    size_t size;
+    int kind;
+    // the C name of the field's record or enum type, or NULL
+    const char* type_name;
+    // the number of elements for fixed-size arrays, otherwise 1
+    size_t count;
+} cppmm_field_info;
+
+typedef struct {
+    const char* name;
+    size_t size;
+    size_t alignment;
+    const cppmm_field_info* fields;
+    size_t field_count;
+} cppmm_record_info;
+
+typedef struct {
+    const char* name;
+    long long value;
+} cppmm_enumerator_info;
+
+typedef struct {
+    const char* name;
+    const cppmm_enumerator_info* enumerators;
+    size_t enumerator_count;
+} cppmm_enum_info;
+
+)#";
+}
+
+void write_containers_header(const std::string& filename,
+                             const std::string& map_declarations) {
+    const std::string header = fmt::format(
+        R"#(
 #pragma once
+#include <stddef.h>
+
 #ifdef __cplusplus
-extern "C" {
+extern "C" {{
 #else
 #include <stdbool.h>
 #endif
@@ -235,27 +1138,162 @@ extern "C" {
 #else
 #define CPPMM_ALIGN(x) __attribute__((aligned(x)))
 #endif
+{0}
+
+typedef struct {{ char _private[24]; }} cppmm_string_vector CPPMM_ALIGN(8);
+
+{1}void cppmm_string_vector_ctor(cppmm_string_vector* vec);
+{1}void cppmm_string_vector_dtor(const cppmm_string_vector* vec);
+{1}const char* cppmm_string_vector_get(const cppmm_string_vector* vec, int index);
+{1}int cppmm_string_vector_size(const cppmm_string_vector* vec);
+
+// Packed format for moving a whole vector of strings in one call: the strings
+// are concatenated without terminators into bytes, and string i is
+// bytes[offsets[i], offsets[i+1]), so offsets has one more entry than there are
+// strings.
+{1}void cppmm_string_vector_packed_size(const cppmm_string_vector* vec, size_t* bytes_len, size_t* offsets_len);
+// Returns false, writing nothing, if either buffer is too small
+{1}bool cppmm_string_vector_export(const cppmm_string_vector* vec, char* bytes, size_t bytes_len, size_t* offsets, size_t offsets_len);
+// Replaces the contents of vec with the count strings packed in bytes
+{1}void cppmm_string_vector_import(cppmm_string_vector* vec, const char* bytes, const size_t* offsets, size_t count);
+
+// A borrowed, not necessarily NUL-terminated, string. Only valid for as long
+// as the object it was returned from.
+typedef struct {{
+    const char* ptr;
+    size_t len;
+}} cppmm_string_view;
+
+// An owned std::string that a function has moved its result into. Must be
+// destroyed with cppmm_string_dtor() and must not be copied bitwise.
+typedef struct {{ char _private[32]; }} cppmm_string CPPMM_ALIGN(8);
+
+{1}void cppmm_string_dtor(cppmm_string* str);
+{1}const char* cppmm_string_c_str(const cppmm_string* str);
+{1}size_t cppmm_string_size(const cppmm_string* str);
+{1}cppmm_string_view cppmm_string_as_view(const cppmm_string* str);
+
+// Allocator used for every OpaquePtr object the library creates with a _new()
+// style constructor. Defaults to the global operator new/delete. Passing NULL
+// for both functions restores the default.
+typedef void* (*cppmm_allocate_fn)(size_t size, size_t alignment, void* user_data);
+typedef void (*cppmm_deallocate_fn)(void* ptr, size_t size, size_t alignment, void* user_data);
+
+{1}void cppmm_set_allocator(cppmm_allocate_fn allocate, cppmm_deallocate_fn deallocate, void* user_data);
+{1}void* cppmm_allocate(size_t size, size_t alignment);
+{1}void cppmm_deallocate(void* ptr, size_t size, size_t alignment);
+{4}
+{3}{5}{2}
+#ifdef __cplusplus
+}}
+#endif
+    )#",
+        get_export_macro_definition(), get_export_prefix(),
+        get_export_macro_undef(), get_error_declarations(), map_declarations,
+        get_reflection_declarations());
+
+    auto out = fopen(filename.c_str(), "w");
+    fprintf(out, "%s", header.c_str());
+    fclose(out);
+}
+
+// Names of all the functions declared by write_containers_header(), for the
+// export list
+std::vector<std::string> get_containers_symbols() {
+    return {
+        "cppmm_string_vector_ctor",
+        "cppmm_string_vector_dtor",
+        "cppmm_string_vector_get",
+        "cppmm_string_vector_size",
+        "cppmm_string_vector_packed_size",
+        "cppmm_string_vector_export",
+        "cppmm_string_vector_import",
+        "cppmm_string_dtor",
+        "cppmm_string_c_str",
+        "cppmm_string_size",
+        "cppmm_string_as_view",
+        "cppmm_set_allocator",
+        "cppmm_allocate",
+        "cppmm_deallocate",
+    };
+}
+
+std::vector<std::string> get_error_symbols() {
+    if (!options.catch_exceptions) {
+        return {};
+    }
+    return {
+        "cppmm_error_code",
+        "cppmm_error_message",
+        "cppmm_clear_error",
+    };
+}
 
+std::string get_error_implementation() {
+    if (!options.catch_exceptions) {
+        return "";
+    }
 
-typedef struct { char _private[24]; } cppmm_string_vector CPPMM_ALIGN(8);
+    return R"#(
+#include <cstring>
+#include <exception>
+#include <new>
 
-const char* cppmm_string_vector_get(const cppmm_string_vector* vec, int index);
-int cppmm_string_vector_size(const cppmm_string_vector* vec);
+namespace {
 
+struct ErrorRecord {
+    int code;
+    char message[256];
+};
 
-#ifdef __cplusplus
+thread_local ErrorRecord current_error = {CPPMM_ERROR_NONE, {0}};
+
+void set_error(int code, const char* message) {
+    current_error.code = code;
+    strncpy(current_error.message, message, sizeof(current_error.message) - 1);
+    current_error.message[sizeof(current_error.message) - 1] = '\0';
 }
-#endif
-    )#";
 
-    auto out = fopen(filename.c_str(), "w");
-    fprintf(out, "%s", header.c_str());
-    fclose(out);
 }
 
-void write_containers_implementation(const std::string& filename) {
-    const std::string src = R"#(
+extern "C" {
+
+void cppmm_set_error_from_current_exception() {
+    try {
+        throw;
+    } catch (const std::bad_alloc& e) {
+        set_error(CPPMM_ERROR_BAD_ALLOC, e.what());
+    } catch (const std::exception& e) {
+        set_error(CPPMM_ERROR_EXCEPTION, e.what());
+    } catch (...) {
+        set_error(CPPMM_ERROR_UNKNOWN, "unknown exception");
+    }
+}
+
+int cppmm_error_code() {
+    return current_error.code;
+}
+
+const char* cppmm_error_message() {
+    return current_error.message;
+}
+
+void cppmm_clear_error() {
+    current_error.code = CPPMM_ERROR_NONE;
+    current_error.message[0] = '\0';
+}
+
+}
+)#";
+}
+
+void write_containers_implementation(
+    const std::string& filename, const std::set<std::string>& map_casts,
+    const std::string& map_definitions) {
+    std::string src = R"#(
 #include "cppmm_containers.h"
+#include <algorithm>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -263,13 +1301,52 @@ namespace {
 #include "casts.h"
 
 CPPMM_DEFINE_POINTER_CASTS(std::vector<std::string>, cppmm_string_vector);
+CPPMM_DEFINE_POINTER_CASTS(std::string, cppmm_string);
+
+// cppmm_string is sized to hold std::string from both libstdc++ and libc++
+static_assert(sizeof(std::string) <= sizeof(cppmm_string),
+              "cppmm_string is too small for std::string");
+static_assert(alignof(std::string) <= alignof(cppmm_string),
+              "cppmm_string is not aligned enough for std::string");
+
+// Over-aligned requests need the aligned operator new, which is only there
+// from C++17
+void* default_allocate(size_t size, size_t alignment, void* user_data) {
+#if __cpp_aligned_new
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+#endif
+    return ::operator new(size);
+}
 
+void default_deallocate(void* ptr, size_t size, size_t alignment, void* user_data) {
+#if __cpp_aligned_new
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        ::operator delete(ptr, std::align_val_t(alignment));
+        return;
+    }
+#endif
+    ::operator delete(ptr);
+}
+
+cppmm_allocate_fn allocate_fn = default_allocate;
+cppmm_deallocate_fn deallocate_fn = default_deallocate;
+void* allocator_user_data = nullptr;
 
 #undef CPPMM_DEFINE_POINTER_CASTS
 }
 
 extern "C" {
 
+void cppmm_string_vector_ctor(cppmm_string_vector* vec) {
+    new (vec) std::vector<std::string>();
+}
+
+void cppmm_string_vector_dtor(const cppmm_string_vector* vec) {
+    to_cpp(vec)->~vector();
+}
+
 const char* cppmm_string_vector_get(const cppmm_string_vector* vec, int index) {
     return (*to_cpp(vec))[index].c_str();
 }
@@ -278,24 +1355,263 @@ int cppmm_string_vector_size(const cppmm_string_vector* vec) {
     return to_cpp(vec)->size();
 }
 
+void cppmm_string_vector_packed_size(const cppmm_string_vector* vec, size_t* bytes_len, size_t* offsets_len) {
+    const std::vector<std::string>& v = *to_cpp(vec);
+    size_t total = 0;
+    for (const auto& s : v) {
+        total += s.size();
+    }
+    *bytes_len = total;
+    *offsets_len = v.size() + 1;
+}
+
+bool cppmm_string_vector_export(const cppmm_string_vector* vec, char* bytes, size_t bytes_len, size_t* offsets, size_t offsets_len) {
+    const std::vector<std::string>& v = *to_cpp(vec);
+    if (offsets_len < v.size() + 1) {
+        return false;
+    }
+
+    size_t total = 0;
+    for (const auto& s : v) {
+        total += s.size();
+    }
+    if (bytes_len < total) {
+        return false;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < v.size(); ++i) {
+        offsets[i] = offset;
+        memcpy(bytes + offset, v[i].data(), v[i].size());
+        offset += v[i].size();
+    }
+    offsets[v.size()] = offset;
+    return true;
+}
+
+void cppmm_string_vector_import(cppmm_string_vector* vec, const char* bytes, const size_t* offsets, size_t count) {
+    std::vector<std::string>& v = *to_cpp(vec);
+    v.clear();
+    v.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        v.emplace_back(bytes + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+}
+
+void cppmm_string_dtor(cppmm_string* str) {
+    using std::string;
+    to_cpp(str)->~string();
+}
+
+const char* cppmm_string_c_str(const cppmm_string* str) {
+    return to_cpp(str)->c_str();
+}
+
+size_t cppmm_string_size(const cppmm_string* str) {
+    return to_cpp(str)->size();
+}
+
+cppmm_string_view cppmm_string_as_view(const cppmm_string* str) {
+    const std::string& s = *to_cpp(str);
+    return cppmm_string_view{s.data(), s.size()};
+}
+
+void cppmm_set_allocator(cppmm_allocate_fn allocate, cppmm_deallocate_fn deallocate, void* user_data) {
+    if (allocate == nullptr && deallocate == nullptr) {
+        allocate_fn = default_allocate;
+        deallocate_fn = default_deallocate;
+        allocator_user_data = nullptr;
+    } else {
+        allocate_fn = allocate;
+        deallocate_fn = deallocate;
+        allocator_user_data = user_data;
+    }
+}
+
+void* cppmm_allocate(size_t size, size_t alignment) {
+    return allocate_fn(size, alignment, allocator_user_data);
+}
+
+void cppmm_deallocate(void* ptr, size_t size, size_t alignment) {
+    deallocate_fn(ptr, size, alignment, allocator_user_data);
+}
+
 }
     )#";
 
+    if (!map_definitions.empty()) {
+        // the maps need their casts defined along with the others, before the
+        // macro is undefined, and their definitions at the end of the
+        // extern "C" block
+        std::string casts = "#include \"casts.h\"\n\n";
+        for (const auto& s : map_casts) {
+            casts += s;
+        }
+        src = ps::replace(src, "#include \"casts.h\"\n", casts, 1);
+        src = ps::replace(src, "#include <vector>\n",
+                          "#include <vector>\n#include <map>\n#include <set>\n"
+                          "#include <unordered_map>\n#include <unordered_set>\n",
+                          1);
+        src.insert(src.rfind('}'), map_definitions + "\n");
+    }
+
     auto out = fopen(filename.c_str(), "w");
-    fprintf(out, "%s", src.c_str());
+    fprintf(out, "%s%s", src.c_str(), get_error_implementation().c_str());
+    fclose(out);
+}
+
+// Write the list of bound entry points in the two formats the linkers we care
+// about understand: a GNU version script and a macOS exported symbols list.
+// Everything not in the list stays local to the shared library.
+void write_export_lists(const std::string& output_dir,
+                        const std::string& project_name,
+                        const std::vector<std::string>& symbols) {
+    std::string version_script = "{\n  global:\n";
+    std::string exported_symbols;
+    for (const auto& sym : symbols) {
+        version_script += fmt::format("    {};\n", sym);
+        exported_symbols += fmt::format("_{}\n", sym);
+    }
+    version_script += "  local:\n    *;\n};\n";
+
+    const std::string map_path =
+        fs::path(output_dir) / fmt::format("{}.map", project_name);
+    auto out = fopen(map_path.c_str(), "w");
+    fprintf(out, "%s", version_script.c_str());
     fclose(out);
+
+    const std::string exp_path =
+        fs::path(output_dir) / fmt::format("{}.exp", project_name);
+    out = fopen(exp_path.c_str(), "w");
+    fprintf(out, "%s", exported_symbols.c_str());
+    fclose(out);
+}
+
+// Gather the headers that every generated implementation file includes so that
+// they can be compiled once as a precompiled header for the whole project.
+// casts.h is deliberately not in the list since it defines functions and is
+// included inside an anonymous namespace in each file.
+std::vector<std::string>
+get_precompiled_headers(const ExportedFileMap& ex_files) {
+    // standard headers used by the generated wrappers and casts.h
+    std::vector<std::string> result = {"<stddef.h>", "<string.h>",
+                                       "<algorithm>", "<new>",
+                                       "<string>",    "<utility>",
+                                       "<vector>"};
+    std::set<std::string> seen(result.begin(), result.end());
+
+    for (const auto& bind_file : ex_files) {
+        for (const auto& include : bind_file.second.includes) {
+            // includes are stored as the whole "#include <foo.h>" line
+            std::string header = include.substr(8);
+            const auto comment = header.find("//");
+            if (comment != std::string::npos) {
+                header = header.substr(0, comment);
+            }
+            header = ps::strip(header);
+            if (header.empty()) {
+                continue;
+            }
+
+            // CMake wants quoted includes wrapped in a bracket argument so
+            // that the quotes survive
+            if (header[0] == '"') {
+                header = fmt::format("[[{}]]", header);
+            }
+
+            if (seen.insert(header).second) {
+                result.push_back(header);
+            }
+        }
+    }
+
+    return result;
 }
 
 void write_cmakelists(const std::string& filename,
                       const std::string& project_name,
                       const std::vector<std::string> source_files,
                       const std::vector<std::string>& includes,
-                      const std::vector<std::string>& libraries) {
+                      const std::vector<std::string>& libraries,
+                      const std::vector<std::string>& pch_headers) {
+    // minor version of the minimum CMake 3 we need for the features used
+    int cmake_minor = 5;
+    std::string extra;
+
+    if (!pch_headers.empty()) {
+        // target_precompile_headers() was added in 3.16
+        cmake_minor = std::max(cmake_minor, 16);
+        extra += fmt::format(R"#(
+target_precompile_headers({0} PRIVATE
+  {1}
+)
+)#",
+                             project_name, ps::join("\n  ", pch_headers));
+    }
+
+    std::string library_type = "STATIC";
+    if (options.shared) {
+        // Hide everything, including the helpers from casts.h, then export
+        // exactly the entry points listed by write_export_lists().
+        // target_link_options() was added in 3.13
+        cmake_minor = std::max(cmake_minor, 13);
+        library_type = "SHARED";
+        extra += fmt::format(R"#(
+set_target_properties({0} PROPERTIES
+  C_VISIBILITY_PRESET hidden
+  CXX_VISIBILITY_PRESET hidden
+  VISIBILITY_INLINES_HIDDEN ON
+)
+
+target_compile_definitions({0} PRIVATE
+  CPPMM_EXPORTS
+)
+
+if(APPLE)
+  target_link_options({0} PRIVATE
+    -Wl,-exported_symbols_list,${{CMAKE_CURRENT_SOURCE_DIR}}/{0}.exp
+  )
+elseif(NOT WIN32)
+  target_link_options({0} PRIVATE
+    -Wl,--version-script=${{CMAKE_CURRENT_SOURCE_DIR}}/{0}.map
+  )
+endif()
+)#",
+                             project_name);
+    }
+
+    if (options.lto) {
+        // The wrappers are almost all trivial forwarders, so the win comes from
+        // the caller's link inlining them. We build the archive as ThinLTO
+        // bitcode (CMake picks llvm-ar for us when IPO is on) and hand callers
+        // an interface target that puts them into the same LTO link.
+        // target_link_options() was added in 3.13
+        cmake_minor = std::max(cmake_minor, 13);
+        extra += fmt::format(R"#(
+set_property(TARGET {0} PROPERTY INTERPROCEDURAL_OPTIMIZATION ON)
+target_compile_options({0} PRIVATE
+  -flto=thin
+)
+
+add_library({0}-lto INTERFACE)
+target_link_libraries({0}-lto INTERFACE
+  {0}
+)
+target_compile_options({0}-lto INTERFACE
+  -flto=thin
+)
+target_link_options({0}-lto INTERFACE
+  -flto=thin
+)
+)#",
+                             project_name);
+    }
+
     const std::string src =
-        fmt::format(R"#(cmake_minimum_required(VERSION 3.5)
+        fmt::format(R"#(cmake_minimum_required(VERSION 3.{4})
 project({0})
 
-add_library({0} STATIC
+add_library({0} {6}
   {1}
 )
 
@@ -310,9 +1626,10 @@ target_include_directories({0} PUBLIC
 target_link_libraries({0} PUBLIC
   {3}
 )
-)#",
+{5})#",
                     project_name, ps::join("\n  ", source_files),
-                    ps::join("\n  ", includes), ps::join("\n  ", libraries));
+                    ps::join("\n  ", includes), ps::join("\n  ", libraries),
+                    cmake_minor, extra, library_type);
     auto out = fopen(filename.c_str(), "w");
     fprintf(out, "%s", src.c_str());
     fclose(out);
@@ -325,9 +1642,14 @@ void GeneratorC::generate(const std::string& output_dir,
                           const ExportedFileMap& ex_files, const FileMap& files,
                           const RecordMap& records, const EnumMap& enums,
                           const VectorMap& vectors,
+                          const SharedPtrMap& shared_ptrs, const MapMap& maps,
                           const std::vector<std::string>& project_includes,
                           const std::vector<std::string>& project_libraries) {
     std::vector<std::string> source_files;
+    std::vector<std::string> exported_symbols = get_containers_symbols();
+    for (const auto& symbol : get_error_symbols()) {
+        exported_symbols.push_back(symbol);
+    }
     fs::path output_dir_path = fs::path(output_dir);
     std::string project_name = output_dir_path.stem();
 
@@ -338,34 +1660,139 @@ void GeneratorC::generate(const std::string& output_dir,
 
         std::set<std::string> header_includes;
         header_includes.insert("cppmm_containers.h");
+        // inline accessors of opaquebytes records memcpy fields out of them
+        bool header_uses_memcpy = false;
 
         if (bind_file.first == "") {
             // FIXME: how is this getting in there?
             continue;
         }
 
+        std::vector<std::string> record_order;
+        std::set<std::string> ordered_records;
         for (const auto& rec_pair : bind_file.second.records) {
-            const auto it_record = records.find(rec_pair.first);
+            order_records(rec_pair.first, bind_file.second, records,
+                          ordered_records, record_order);
+        }
+
+        for (const auto& record_c_qname : record_order) {
+            const auto it_record = records.find(record_c_qname);
             if (it_record == records.end()) {
                 fmt::print("ERROR: record {} not found in records map\n",
-                           rec_pair.first);
+                           record_c_qname);
                 continue;
             }
 
             const auto& record = it_record->second;
             declarations += record.get_declaration(casts_macro_invocations);
+            const std::string reflection_declaration =
+                record.get_reflection_declaration(get_export_prefix());
+            if (!reflection_declaration.empty()) {
+                declarations += reflection_declaration;
+                exported_symbols.push_back("cppmm_reflect_" + record.c_qname);
+                definitions += record.get_reflection_definition();
+            }
+            declarations += record.get_constant_declarations();
+            for (const auto& constant : record.constants) {
+                if (const Record* constant_record =
+                        constant.qtype.type.var.cast_or_null<Record>()) {
+                    header_includes.insert(constant_record->filename);
+                } else if (const Enum* enm =
+                               constant.qtype.type.var.cast_or_null<Enum>()) {
+                    header_includes.insert(enm->filename);
+                }
+            }
+            if (record.kind == RecordKind::ValueType) {
+                // nested records and enums declared in other files
+                for (const auto& field : record.fields) {
+                    if (const Record* field_record =
+                            field.qtype.type.var.cast_or_null<Record>()) {
+                        header_includes.insert(field_record->filename);
+                    } else if (const Enum* enm =
+                                   field.qtype.type.var.cast_or_null<Enum>()) {
+                        header_includes.insert(enm->filename);
+                    }
+                }
+            }
+            const bool has_destroy = has_allocating_constructor(record);
+            const bool has_free = is_returned_as_pointer(record, files, records);
+            if (record.kind == RecordKind::OpaquePtr) {
+                declarations += get_opaqueptr_storage_declaration(
+                    record, has_destroy, has_free);
+                const auto storage_symbols = get_opaqueptr_storage_symbols(
+                    record, has_destroy, has_free);
+                exported_symbols.insert(exported_symbols.end(),
+                                        storage_symbols.begin(),
+                                        storage_symbols.end());
+            }
 
             const auto it_vec = vectors.find(record.c_qname);
             if (it_vec != vectors.end()) {
                 if (it_vec->second.element_type.type.name == "basic_string") {
                 } else {
                     declarations += get_vector_declaration(it_vec->second);
+                    const auto vector_symbols =
+                        get_vector_symbols(it_vec->second);
+                    exported_symbols.insert(exported_symbols.end(),
+                                            vector_symbols.begin(),
+                                            vector_symbols.end());
                     definitions += get_vector_implementation(
                         it_vec->second, casts_macro_invocations);
                 }
             }
 
+            for (const cppmm::Map* map : get_home_maps(maps, &record)) {
+                // the key may be a record from somewhere else
+                if (const Record* key_record =
+                        map->key_type.type.var.cast_or_null<Record>()) {
+                    header_includes.insert(key_record->filename);
+                }
+                declarations += get_map_declaration(*map);
+                const auto map_symbols = get_map_symbols(*map);
+                exported_symbols.insert(exported_symbols.end(),
+                                        map_symbols.begin(), map_symbols.end());
+                definitions +=
+                    get_map_implementation(*map, casts_macro_invocations);
+            }
+
+            const auto it_sptr = shared_ptrs.find(record.c_qname);
+            if (it_sptr != shared_ptrs.end()) {
+                declarations += get_shared_ptr_declaration(it_sptr->second);
+                const auto sptr_symbols = get_shared_ptr_symbols(it_sptr->second);
+                exported_symbols.insert(exported_symbols.end(),
+                                        sptr_symbols.begin(),
+                                        sptr_symbols.end());
+                definitions += get_shared_ptr_implementation(
+                    it_sptr->second, casts_macro_invocations);
+            }
+
             definitions += record.get_definition();
+            if (record.kind == RecordKind::OpaquePtr) {
+                definitions += get_opaqueptr_storage_implementation(
+                    record, has_destroy, has_free);
+            }
+
+            if (!record.accessor_fields.empty()) {
+                casts_macro_invocations.insert(record.create_casts());
+                for (const auto& field : record.accessor_fields) {
+                    if (const Record* field_record =
+                            field.qtype.type.var.cast_or_null<Record>()) {
+                        header_includes.insert(field_record->filename);
+                        casts_macro_invocations.insert(
+                            field_record->create_casts());
+                    } else if (const Enum* enm =
+                                   field.qtype.type.var.cast_or_null<Enum>()) {
+                        header_includes.insert(enm->filename);
+                    }
+                }
+                declarations += get_field_accessor_declaration(record);
+                const auto accessor_symbols =
+                    get_field_accessor_symbols(record);
+                exported_symbols.insert(exported_symbols.end(),
+                                        accessor_symbols.begin(),
+                                        accessor_symbols.end());
+                definitions += get_field_accessor_implementation(record);
+            }
         }
 
         for (const auto& enm_pair : bind_file.second.enums) {
@@ -377,6 +1804,13 @@ void GeneratorC::generate(const std::string& output_dir,
             }
             const auto& enm = it_enum->second;
             declarations += enm.get_declaration();
+            const std::string reflection_declaration =
+                enm.get_reflection_declaration(get_export_prefix());
+            if (!reflection_declaration.empty()) {
+                declarations += reflection_declaration;
+                exported_symbols.push_back("cppmm_reflect_" + enm.c_qname);
+                definitions += enm.get_reflection_definition();
+            }
         }
 
         const auto it_file = files.find(bind_file.first);
@@ -389,11 +1823,35 @@ void GeneratorC::generate(const std::string& output_dir,
 
                 std::string definition = function.get_definition(declaration);
 
-                declarations = fmt::format("{}\n{}\n{};\n", declarations,
-                                           function.comment, declaration);
-
-                definitions =
-                    fmt::format("{}\n{}\n\n\n", definitions, definition);
+                declarations = fmt::format(
+                    "{}\n{}{}\n{}{}{};\n", declarations,
+                    get_guarded_type_declarations(function), function.comment,
+                    get_export_prefix(),
+                    get_c_attributes(function, false, false, false),
+                    declaration);
+                declarations += get_constant_declaration(function);
+                exported_symbols.push_back(function.c_qname);
+
+                definitions = fmt::format("{}\n{}{}\n\n\n", definitions,
+                                          get_lto_inline_prefix(), definition);
+
+                if (function.is_batch && function.can_batch()) {
+                    std::string batch_declaration =
+                        function.get_batch_declaration();
+                    declarations = fmt::format("{}{}{};\n", declarations,
+                                               get_export_prefix(),
+                                               batch_declaration);
+                    exported_symbols.push_back(function.c_qname + "_batch");
+
+                    definitions = fmt::format(
+                        "{}\n{}\n\n\n", definitions,
+                        function.get_batch_definition(batch_declaration));
+                } else if (function.is_batch) {
+                    fmt::print("WARNING: function {} has parameters or a "
+                               "return type that cannot be passed as arrays. "
+                               "No batch variant will be generated.\n",
+                               declaration);
+                }
             }
         }
 
@@ -415,11 +1873,56 @@ void GeneratorC::generate(const std::string& output_dir,
                 std::string definition =
                     record.get_method_definition(method, declaration);
 
-                declarations = fmt::format("{}\n{}\n{};\n", declarations,
-                                           method.comment, declaration);
+                declarations = fmt::format(
+                    "{}\n{}{}\n{}{}{};\n", declarations,
+                    get_guarded_type_declarations(method), method.comment,
+                    get_export_prefix(), record.get_method_attributes(method),
+                    declaration);
+                declarations += get_constant_declaration(method);
+                declarations += record.get_method_inline_definition(method);
+                if (!method.inline_expression.empty() &&
+                    !method.inline_fields.empty()) {
+                    header_uses_memcpy = true;
+                }
+                exported_symbols.push_back(method.c_qname);
+
+                definitions = fmt::format("{}\n{}{}\n\n\n", definitions,
+                                          get_lto_inline_prefix(), definition);
+
+                if (method.is_constructor &&
+                    record.kind == RecordKind::OpaquePtr) {
+                    std::string at_declaration =
+                        record.get_construct_at_declaration(method);
+                    declarations = fmt::format("{}{}{};\n", declarations,
+                                               get_export_prefix(),
+                                               at_declaration);
+                    exported_symbols.push_back(method.c_qname + "_at");
+
+                    definitions = fmt::format(
+                        "{}\n{}\n\n\n", definitions,
+                        record.get_construct_at_definition(method,
+                                                           at_declaration));
+                }
 
-                definitions =
-                    fmt::format("{}\n{}\n\n\n", definitions, definition);
+                if (method.is_batch && record.can_batch_method(method)) {
+                    std::string batch_declaration =
+                        record.get_method_batch_declaration(method);
+                    declarations = fmt::format("{}{}{};\n", declarations,
+                                               get_export_prefix(),
+                                               batch_declaration);
+                    exported_symbols.push_back(method.c_qname + "_batch");
+
+                    definitions = fmt::format(
+                        "{}\n{}\n\n\n", definitions,
+                        record.get_method_batch_definition(method,
+                                                           batch_declaration));
+                } else if (method.is_batch) {
+                    fmt::print("WARNING: method {} has parameters or a "
+                               "return type that cannot be passed as arrays, "
+                               "or is a method of an OpaquePtr record. No "
+                               "batch variant will be generated.\n",
+                               declaration);
+                }
             }
         }
 
@@ -429,6 +1932,9 @@ void GeneratorC::generate(const std::string& output_dir,
 
         // fmt::print("INCLUDES FOR {}\n", root);
         std::string header_include_stmts;
+        if (header_uses_memcpy) {
+            header_include_stmts += "#include <string.h>\n";
+        }
         for (const auto& i : header_includes) {
             const std::string include_root = bind_file_root(i);
             if (include_root != root) {
@@ -453,14 +1959,39 @@ void GeneratorC::generate(const std::string& output_dir,
     }
 
     write_casts_header(fs::path(output_dir) / "casts.h");
-    write_containers_header(fs::path(output_dir) / "cppmm_containers.h");
+    // maps of builtins and strings have no record to go with so they go in
+    // with the other containers
+    std::string map_declarations;
+    std::string map_definitions;
+    std::set<std::string> map_casts;
+    for (const cppmm::Map* map : get_home_maps(maps, nullptr)) {
+        map_declarations += get_map_declaration(*map);
+        const auto map_symbols = get_map_symbols(*map);
+        exported_symbols.insert(exported_symbols.end(), map_symbols.begin(),
+                                map_symbols.end());
+        map_definitions += get_map_implementation(*map, map_casts);
+    }
+
+    write_containers_header(fs::path(output_dir) / "cppmm_containers.h",
+                            map_declarations);
     std::string containers_implementation =
         fs::path(output_dir) / "cppmm_containers.cpp";
-    write_containers_implementation(containers_implementation);
+    write_containers_implementation(containers_implementation, map_casts,
+                                    map_definitions);
     source_files.push_back("cppmm_containers.cpp");
 
+    if (options.shared) {
+        write_export_lists(output_dir, project_name, exported_symbols);
+    }
+
+    std::vector<std::string> pch_headers;
+    if (options.precompiled_headers) {
+        pch_headers = get_precompiled_headers(ex_files);
+    }
+
     write_cmakelists(output_dir_path / "CMakeLists.txt", project_name,
-                     source_files, project_includes, project_libraries);
+                     source_files, project_includes, project_libraries,
+                     pch_headers);
 }
 
 } // namespace cppmm
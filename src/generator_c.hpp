@@ -13,6 +13,7 @@ public:
     generate(const std::string& output_dir, const ExportedFileMap& ex_files,
              const FileMap& files, const RecordMap& records,
              const EnumMap& enums, const VectorMap& vectors,
+             const SharedPtrMap& shared_ptrs, const MapMap& maps,
              const std::vector<std::string>& project_includes,
              const std::vector<std::string>& project_libraries) override;
 };
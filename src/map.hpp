@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <fmt/format.h>
+
+#include "type.hpp"
+
+namespace cppmm {
+
+// A std::map, std::unordered_map, std::set or std::unordered_set. These are
+// passed around as opaque handles and read through cursors that point into
+// the live container, so nothing is copied out of them.
+struct Map {
+    QualifiedType key_type;
+    // the same as key_type for sets
+    QualifiedType value_type;
+    bool is_set;
+    // the full C++ type, including any comparator, hasher and allocator
+    std::string cpp_qname;
+    std::string c_qname;
+
+    std::string create_casts() const {
+        // the C++ type has commas in it so it needs a typedef to go through
+        // the macro
+        return fmt::format("typedef {1} {0}_type;\n"
+                           "CPPMM_DEFINE_POINTER_CASTS({0}_type, {0});\n",
+                           c_qname, cpp_qname);
+    }
+
+    // The record this map is declared alongside, or nullptr if its key and
+    // value are builtins or strings, in which case it goes in
+    // cppmm_containers
+    const Record* get_home_record() const {
+        if (const Record* record = value_type.type.var.cast_or_null<Record>()) {
+            return record;
+        }
+        return key_type.type.var.cast_or_null<Record>();
+    }
+};
+
+} // namespace cppmm
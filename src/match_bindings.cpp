@@ -85,10 +85,17 @@ void MatchBindingsCallback::handle_enum(const EnumDecl* enum_decl) {
 }
 
 void MatchBindingsCallback::handle_record(const CXXRecordDecl* record) {
+    // templates themselves can't be bound, only explicit specializations of
+    // them
+    if (record->getDescribedClassTemplate() != nullptr ||
+        record->isDependentContext()) {
+        return;
+    }
+
     cppmm::ExportedRecord ex_record;
 
-    ex_record.cpp_name = record->getNameAsString();
-    ex_record.c_name = ex_record.cpp_name;
+    get_record_names(record, ex_record.cpp_name, ex_record.c_name);
+    ex_record.match_name = record->getNameAsString();
     ex_record.namespaces = get_namespaces(record->getParent());
     ex_record.c_qname =
         cppmm::prefix_from_namespaces(ex_record.namespaces, "_") +
@@ -158,8 +165,14 @@ void MatchBindingsCallback::handle_function(const FunctionDecl* function) {
 void MatchBindingsCallback::handle_method(const CXXMethodDecl* method) {
     // If there are attributes, parse them looking for cppmm annotations
     std::vector<cppmm::AttrDesc> attrs = get_attrs(method);
+    if (method->getParent()->isDependentContext()) {
+        return;
+    }
+
     cppmm::ExportedMethod ex_method(method, attrs);
-    const auto class_name = method->getParent()->getNameAsString();
+    std::string cpp_class_name;
+    std::string class_name;
+    get_record_names(method->getParent(), cpp_class_name, class_name);
 
     // check if we've seen the class this method belongs to before, and
     // if not process it
@@ -170,8 +183,9 @@ void MatchBindingsCallback::handle_method(const CXXMethodDecl* method) {
         std::string filename = sm.getFilename(method->getBeginLoc());
 
         auto namespaces = get_namespaces(method->getParent()->getParent());
-        ex_classes[class_name] =
-            cppmm::ExportedClass{class_name, filename, namespaces, {}};
+        ex_classes[class_name] = cppmm::ExportedClass{
+            class_name, method->getParent()->getNameAsString(), filename,
+            namespaces, {}};
 
         if (ex_files.find(filename) == ex_files.end()) {
             ex_files[filename] = {};
@@ -5,6 +5,8 @@
 
 #include <fmt/format.h>
 
+#include <set>
+
 using namespace clang;
 using namespace clang::ast_matchers;
 
@@ -99,14 +101,21 @@ void MatchDeclsHandler::handle_function(const FunctionDecl* function) {
 
 void MatchDeclsHandler::handle_method(const CXXMethodDecl* method) {
     const auto method_name = method->getNameAsString();
+    // methods of the template itself, or of specializations we're not binding
+    if (method->getParent()->isDependentContext()) {
+        return;
+    }
     auto* record = cppmm::process_record(method->getParent());
-    if (record == nullptr) {
+    if (record == nullptr &&
+        isa<ClassTemplateSpecializationDecl>(method->getParent())) {
+        return;
+    } else if (record == nullptr) {
         fmt::print("ERROR could not process record for {}\n",
                    method->getParent()->getNameAsString());
         abort();
     }
 
-    auto it_class = cppmm::ex_classes.find(record->cpp_name);
+    auto it_class = cppmm::ex_classes.find(record->c_name);
     if (it_class == cppmm::ex_classes.end()) {
         return;
     }
@@ -158,7 +167,7 @@ MatchDeclsConsumer::MatchDeclsConsumer(ASTContext* context) {
         for (const auto& record : ex_file.second.records) {
             DeclarationMatcher record_decl_matcher =
                 cxxRecordDecl(
-                    hasName(record.second->cpp_name),
+                    hasName(record.second->match_name),
                     unless(hasAncestor(namespaceDecl(hasName("cppmm_bind")))),
                     unless(isImplicit()))
                     .bind("recordDecl");
@@ -175,12 +184,19 @@ MatchDeclsConsumer::MatchDeclsConsumer(ASTContext* context) {
         _match_finder.addMatcher(enum_decl_matcher, &_handler);
     }
 
+    // every bound specialization of a template shares the template's name,
+    // so only add one matcher for them all. handle_method() then sorts the
+    // methods out by the specialization they belong to
+    std::set<std::string> method_match_names;
     for (const auto& input_class : cppmm::ex_classes) {
+        if (!method_match_names.insert(input_class.second.match_name).second) {
+            continue;
+        }
         // Match all class methods that are NOT in the cppmm_bind
         // namespace (or we'll get duplicates)
         DeclarationMatcher method_decl_matcher =
             cxxMethodDecl(
-                isPublic(), ofClass(hasName(input_class.first)),
+                isPublic(), ofClass(hasName(input_class.second.match_name)),
                 unless(hasAncestor(namespaceDecl(hasName("cppmm_bind")))))
                 .bind("methodDecl");
         _match_finder.addMatcher(method_decl_matcher, &_handler);
@@ -8,12 +8,22 @@
 
 namespace cppmm {
 
+// A field of an OpaqueBytes record that an inline expression reads. C only
+// sees the record's bytes, so the field is copied out of them into a local
+// named self_<name> first
+struct InlineField {
+    std::string name;
+    std::string c_type;
+    size_t offset;
+};
+
 struct Method : public Function {
     Method(std::string cpp_name, std::string c_name, QualifiedType return_type,
            std::vector<Param> params, std::string comment,
            std::vector<std::string> namespaces, bool is_const, bool is_static,
            bool is_constructor, bool is_copy_constructor,
-           bool is_copy_assignment, bool is_operator,
+           bool is_copy_assignment, bool is_move_constructor,
+           bool is_move_assignment, bool is_operator,
            bool is_conversion_operator, std::string op);
 
     bool is_const = false;
@@ -21,9 +31,16 @@ struct Method : public Function {
     bool is_constructor = false;
     bool is_copy_constructor = false;
     bool is_copy_assignment = false;
+    bool is_move_constructor = false;
+    bool is_move_assignment = false;
     bool is_operator = false;
     bool is_conversion_operator = false;
     std::string op;
+    // C expression equivalent to the body, in terms of self and the
+    // parameters, if it is simple enough to translate (-inline-accessors)
+    std::string inline_expression;
+    // the fields of an OpaqueBytes self that inline_expression reads
+    std::vector<InlineField> inline_fields;
 };
 
 } // namespace cppmm
@@ -1,5 +1,8 @@
 #include <unordered_map>
 
+#include <clang/AST/DeclTemplate.h>
+#include <clang/AST/QualTypeNames.h>
+
 #include <fmt/format.h>
 
 #include "pystring.h"
@@ -78,4 +81,58 @@ std::vector<std::string> get_namespaces(const clang::DeclContext* parent) {
     return result;
 }
 
+std::string mangle_template_argument(const std::string& arg) {
+    std::string result;
+    // isalnum() is undefined for negative chars, so for any non-ASCII bytes
+    for (const unsigned char c : arg) {
+        if (isalnum(c)) {
+            result += c;
+        } else if (!result.empty() && result.back() != '_') {
+            result += '_';
+        }
+    }
+
+    while (!result.empty() && result.back() == '_') {
+        result.pop_back();
+    }
+    return result;
+}
+
+void get_record_names(const clang::CXXRecordDecl* record, std::string& cpp_name,
+                      std::string& c_name) {
+    cpp_name = record->getNameAsString();
+    c_name = cpp_name;
+
+    const auto* ctsd =
+        clang::dyn_cast<clang::ClassTemplateSpecializationDecl>(record);
+    if (ctsd == nullptr) {
+        return;
+    }
+
+    clang::ASTContext& ctx = record->getASTContext();
+    clang::PrintingPolicy policy(ctx.getLangOpts());
+    policy.SuppressTagKeyword = true;
+
+    std::vector<std::string> cpp_args;
+    std::vector<std::string> c_args;
+    for (const auto& arg : ctsd->getTemplateArgs().asArray()) {
+        std::string arg_str;
+        if (arg.getKind() == clang::TemplateArgument::Type) {
+            arg_str = clang::TypeName::getFullyQualifiedName(
+                arg.getAsType().getCanonicalType(), ctx, policy);
+        } else if (arg.getKind() == clang::TemplateArgument::Integral) {
+            arg_str = arg.getAsIntegral().toString(10);
+        } else {
+            fmt::print("WARNING: unhandled template argument kind in {}\n",
+                       record->getQualifiedNameAsString());
+            arg_str = "unknown";
+        }
+        cpp_args.push_back(arg_str);
+        c_args.push_back(mangle_template_argument(arg_str));
+    }
+
+    cpp_name = fmt::format("{}<{}>", cpp_name, ps::join(", ", cpp_args));
+    c_name = fmt::format("{}_{}", c_name, ps::join("_", c_args));
+}
+
 }
@@ -19,4 +19,11 @@ bool match_namespaces(const std::vector<std::string>& a,
                       const std::vector<std::string>& b);
 
 std::vector<std::string> get_namespaces(const clang::DeclContext* parent);
+
+// Get the C++ and C names of a record. These are just the record's name,
+// unless it's a template specialization, in which case the C++ name has the
+// template arguments (e.g. "Vec3<float>") and the C name has them mangled into
+// it (e.g. "Vec3_float")
+void get_record_names(const clang::CXXRecordDecl* record, std::string& cpp_name,
+                      std::string& c_name);
 }
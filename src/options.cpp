@@ -0,0 +1,7 @@
+#include "options.hpp"
+
+namespace cppmm {
+
+Options options;
+
+} // namespace cppmm
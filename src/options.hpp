@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+
+namespace cppmm {
+
+// Switches that change what the generators emit. These are filled in from the
+// command line in main() before the first pass runs, and are read-only after
+// that.
+struct Options {
+    // Emit target_precompile_headers() in the generated CMakeLists.txt
+    bool precompiled_headers = false;
+    // Build the generated library with ThinLTO, force the wrappers inline and
+    // export an interface target that puts callers in the same LTO link
+    bool lto = false;
+    // Generate a SHARED library with hidden visibility that exports only the
+    // bound entry points
+    bool shared = false;
+    // Return std::string by moving it into a caller-provided cppmm_string, and
+    // const std::string& as a cppmm_string_view, instead of copying into a
+    // caller-provided char buffer
+    bool owned_strings = false;
+    // Pass std::string and string_view parameters as a (const char*, size_t)
+    // pair instead of a NUL-terminated const char*
+    bool string_lengths = false;
+    // Return opaquebytes and vector types by constructing them in storage
+    // provided by the caller instead of returning them by value
+    bool out_param_returns = false;
+    // Pass valuetype and opaquebytes records taken by const reference by
+    // value instead if they are at most this many bytes. 0 disables this
+    size_t by_value_max_size = 0;
+    // Annotate declarations with the attributes we can derive from the C++
+    // declaration (pure/const, nonnull, nothrow, warn_unused_result) so that C
+    // callers can optimize around the calls
+    bool c_attributes = false;
+    // Evaluate constexpr functions without parameters when generating and
+    // emit their results as static const values alongside the functions
+    bool constant_values = false;
+    // Translate valuetype methods whose bodies only do arithmetic on fields
+    // and parameters into static inline C functions in the headers
+    bool inline_accessors = false;
+    // Catch exceptions in wrappers of functions that aren't noexcept and
+    // record them in a thread-local error instead of unwinding into C
+    bool catch_exceptions = false;
+    // Generate getters and setters for the public fields of opaque records,
+    // and _snapshot/_apply functions that copy them all to and from a C
+    // struct in one call
+    bool field_accessors = false;
+    // Emit static const tables describing the fields of valuetype and
+    // opaquebytes records and the enumerators of enums, so C code can walk
+    // them generically
+    bool reflection = false;
+};
+
+extern Options options;
+
+} // namespace cppmm
@@ -1,7 +1,12 @@
 #include "param.hpp"
 #include "enum.hpp"
+#include "func_proto.hpp"
+#include "map.hpp"
 #include "namespaces.hpp"
+#include "options.hpp"
 #include "record.hpp"
+#include "shared_ptr.hpp"
+#include "span.hpp"
 #include "type.hpp"
 
 #include "pystring.h"
@@ -9,14 +14,100 @@
 #include <fmt/format.h>
 
 namespace cppmm {
+bool Param::is_string_slice() const {
+    if (!options.string_lengths) {
+        return false;
+    }
+
+    if (qtype.type.name == "basic_string") {
+        // only strings that are read from, not out parameters
+        return (qtype.is_ref && qtype.is_const) ||
+               (!qtype.is_ref && !qtype.is_ptr);
+    }
+
+    return (qtype.type.name == "string_view" ||
+            qtype.type.name == "basic_string_view") &&
+           !qtype.is_ptr;
+}
+
+bool Param::is_small_value() const {
+    if (options.by_value_max_size == 0 || !qtype.is_ref || qtype.is_rref ||
+        !qtype.is_const) {
+        return false;
+    }
+
+    const Record* record = qtype.type.var.cast_or_null<Record>();
+    return record != nullptr && record->kind != RecordKind::OpaquePtr &&
+           record->size <= options.by_value_max_size;
+}
+
 std::string Param::create_c_declaration() const {
+    if (is_string_slice()) {
+        return fmt::format("const char* {0}, size_t {0}_len", name);
+    } else if (const FuncProto* fp = qtype.type.var.cast_or_null<FuncProto>()) {
+        if (fp->is_std_function) {
+            return fmt::format("{0} {1}, void* {1}_data", fp->c_qname, name);
+        }
+        return fmt::format("{} {}", fp->c_qname, name);
+    } else if (const Span* span = qtype.type.var.cast_or_null<Span>()) {
+        return fmt::format("{0}* {1}, size_t {1}_len",
+                           span->element_type.create_c_declaration(), name);
+    } else if ((qtype.type.var.is<SharedPtr>() || qtype.type.var.is<Map>()) &&
+               !qtype.is_ptr && !qtype.is_ref) {
+        // shared_ptrs and maps passed by value are passed by pointer to the
+        // caller's handle and copied on the C++ side
+        return fmt::format("const {}* {}", qtype.type.get_c_qname(), name);
+    } else if (is_small_value()) {
+        return fmt::format("{} {}", qtype.type.get_c_qname(), name);
+    }
     return fmt::format("{} {}", qtype.create_c_declaration(), name);
 }
 
 std::string Param::create_c_call() const {
     std::string result;
-    if (qtype.is_ref && !(qtype.type.name == "basic_string" ||
-                          qtype.type.name == "string_view")) {
+    if (is_string_slice()) {
+        // construct the view directly from the pointer and length so that we
+        // only allocate when the function actually needs a std::string
+        std::string cpp_type;
+        if (qtype.type.name == "basic_string") {
+            cpp_type = "std::string";
+        } else if (qtype.type.name == "basic_string_view") {
+            cpp_type = "std::string_view";
+        } else {
+            cpp_type = prefix_from_namespaces(qtype.type.namespaces, "::") +
+                       qtype.type.name;
+        }
+        result = fmt::format("{0}({1}, {1}_len)", cpp_type, name);
+    } else if (const FuncProto* fp = qtype.type.var.cast_or_null<FuncProto>()) {
+        result = fp->create_call(name);
+    } else if (const Span* span = qtype.type.var.cast_or_null<Span>()) {
+        std::string ptr = name;
+        if (!span->element_type.type.var.is<Builtin>()) {
+            ptr = fmt::format("reinterpret_cast<{}*>({})",
+                              get_cpp_spelling(span->element_type), name);
+        }
+        result = fmt::format("{}({}, {}_len)", span->cpp_qname, ptr, name);
+    } else if (qtype.is_rref && !(qtype.type.name == "basic_string" ||
+                                  qtype.type.name == "string_view" ||
+                                  qtype.type.name == "basic_string_view")) {
+        // the callee takes ownership of the contents of the object, which is
+        // left valid but unspecified and still has to be destroyed by the
+        // caller
+        if (qtype.requires_cast) {
+            result = fmt::format("std::move(*to_cpp({}))", name);
+        } else {
+            result = fmt::format("std::move(*{})", name);
+        }
+    } else if (is_small_value()) {
+        // the temporary binds to the const reference
+        result = fmt::format("bit_cast<{}>({})",
+                             qtype.type.var.cast<Record>()->cpp_qname, name);
+    } else if ((qtype.type.var.is<SharedPtr>() || qtype.type.var.is<Map>()) &&
+               !qtype.is_ptr) {
+        result = fmt::format("*to_cpp({})", name);
+    } else if (qtype.is_ref && !(qtype.type.name == "basic_string" ||
+                                 qtype.type.name == "string_view" ||
+                                 qtype.type.name == "basic_string_view")) {
         if (qtype.requires_cast) {
             result = fmt::format("*to_cpp({})", name);
         } else {
@@ -27,11 +118,8 @@ std::string Param::create_c_call() const {
             if (record->kind == cppmm::RecordKind::ValueType ||
                 record->kind == cppmm::RecordKind::OpaqueBytes) {
                 // need to bit-cast this
-                result = fmt::format(
-                    "bit_cast<{}>({})",
-                    prefix_from_namespaces(record->namespaces, "::") +
-                        qtype.type.name,
-                    name);
+                result =
+                    fmt::format("bit_cast<{}>({})", record->cpp_qname, name);
             } else {
                 result = fmt::format("to_cpp({})", name);
             }
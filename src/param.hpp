@@ -15,6 +15,14 @@ struct Param {
 
     bool is_pod() const { return qtype.is_pod(); }
 
+    // Is this a string parameter that we can pass as a (pointer, length) pair
+    // rather than as a NUL-terminated char*
+    bool is_string_slice() const;
+
+    // Is this a small record taken by const reference that we pass by value
+    // instead, so that it can go in registers
+    bool is_small_value() const;
+
     std::string create_c_declaration() const;
     std::string create_c_call() const;
 };
@@ -1,6 +1,12 @@
 #include "record.hpp"
 #include "enum.hpp"
+#include "func_proto.hpp"
 #include "namespaces.hpp"
+#include "options.hpp"
+#include "map.hpp"
+#include "shared_ptr.hpp"
+#include "span.hpp"
+#include "sum_type.hpp"
 #include "vector.hpp"
 #include "function.hpp"
 
@@ -18,9 +24,55 @@ std::string Record::create_casts() const {
 }
 
 std::string Record::get_opaqueptr_constructor_body(
-    const std::vector<std::string>& call_params) const {
-    return fmt::format("    return to_c(new {}({}));", cpp_qname,
-                       ps::join(", ", call_params));
+    const std::vector<std::string>& call_params, bool may_throw) const {
+    // allocate through the library's allocator hook rather than the global
+    // heap so that callers can redirect it to their own pools
+    if (may_throw) {
+        // give the storage back if the constructor throws, before the
+        // exception reaches the wrapper's handler
+        return fmt::format(
+            R"#(    void* storage = cppmm_allocate(sizeof({0}), alignof({0}));
+    try {{
+        return to_c(new (storage) {0}({1}));
+    }} catch (...) {{
+        cppmm_deallocate(storage, sizeof({0}), alignof({0}));
+        throw;
+    }})#",
+            cpp_qname, ps::join(", ", call_params));
+    }
+    return fmt::format(
+        R"#(    void* storage = cppmm_allocate(sizeof({0}), alignof({0}));
+    return to_c(new (storage) {0}({1}));)#",
+        cpp_qname, ps::join(", ", call_params));
+}
+
+std::string
+Record::get_construct_at_declaration(const Method& constructor) const {
+    // same as the constructor, but with the storage provided by the caller,
+    // which must be at least _sizeof() bytes with _alignof() alignment
+    std::vector<std::string> param_decls = {"void* storage"};
+    for (const auto& param : constructor.params) {
+        param_decls.push_back(param.create_c_declaration());
+    }
+
+    return get_opaqueptr_constructor_declaration(constructor.c_qname + "_at",
+                                                 param_decls);
+}
+
+std::string
+Record::get_construct_at_definition(const Method& constructor,
+                                    const std::string& declaration) const {
+    std::vector<std::string> call_params;
+    for (const auto& p : constructor.params) {
+        call_params.push_back(p.create_c_call());
+    }
+
+    const std::string body =
+        fmt::format("    return to_c(new (storage) {}({}));", cpp_qname,
+                    ps::join(", ", call_params));
+    return fmt::format(
+        "{} {{\n{}\n}}", declaration,
+        get_exception_safe_body(constructor, declaration, body));
 }
 
 std::string Record::get_valuetype_constructor_body(
@@ -52,6 +104,19 @@ std::string Record::get_method_declaration(
         } else if (const Vector* vector =
                        param.qtype.type.var.cast_or_null<Vector>()) {
             casts_macro_invocations.insert(vector->create_casts());
+        } else if (const SharedPtr* sptr =
+                       param.qtype.type.var.cast_or_null<SharedPtr>()) {
+            insert_shared_ptr_includes(*sptr, includes,
+                                       casts_macro_invocations);
+        } else if (const FuncProto* fp =
+                       param.qtype.type.var.cast_or_null<FuncProto>()) {
+            insert_func_proto_includes(*fp, includes,
+                                       casts_macro_invocations);
+        } else if (const Span* span =
+                       param.qtype.type.var.cast_or_null<Span>()) {
+            insert_span_includes(*span, includes, casts_macro_invocations);
+        } else if (const Map* map = param.qtype.type.var.cast_or_null<Map>()) {
+            insert_map_includes(*map, includes, casts_macro_invocations);
         }
 
         std::string pdecl = param.create_c_declaration();
@@ -64,18 +129,21 @@ std::string Record::get_method_declaration(
         return get_opaqueptr_constructor_declaration(method.c_qname,
                                                      param_decls);
     } else {
-        std::string ret;
-        if (method.return_type.type.name == "basic_string" &&
-            !method.return_type.is_ref && !method.return_type.is_ptr) {
-            ret = "int";
-            param_decls.push_back("char* _result_buffer_ptr");
-            param_decls.push_back("int _result_buffer_len");
-        } else {
-            ret = method.return_type.create_c_declaration();
-            if (const Record* record =
-                    method.return_type.type.var.cast_or_null<Record>()) {
-                casts_macro_invocations.insert(record->create_casts());
-            }
+        std::string ret =
+            get_c_return_declaration(method.return_type, param_decls);
+        if (const Record* record =
+                method.return_type.type.var.cast_or_null<Record>()) {
+            casts_macro_invocations.insert(record->create_casts());
+        } else if (const SharedPtr* sptr =
+                       method.return_type.type.var.cast_or_null<SharedPtr>()) {
+            insert_shared_ptr_includes(*sptr, includes,
+                                       casts_macro_invocations);
+        } else if (const Map* map =
+                       method.return_type.type.var.cast_or_null<Map>()) {
+            insert_map_includes(*map, includes, casts_macro_invocations);
+        } else if (const SumType* sum =
+                       method.return_type.type.var.cast_or_null<SumType>()) {
+            insert_sum_type_includes(*sum, includes, casts_macro_invocations);
         }
 
         if (method.is_static) {
@@ -100,6 +168,82 @@ std::string Record::get_method_declaration(
     }
 }
 
+std::string Record::get_method_inline_definition(const Method& method) const {
+    if (method.inline_expression.empty()) {
+        return "";
+    }
+
+    std::vector<std::string> param_decls;
+    param_decls.push_back(fmt::format("{}{}* self",
+                                      method.is_const ? "const " : "",
+                                      c_qname));
+    for (const auto& param : method.params) {
+        param_decls.push_back(param.create_c_declaration());
+    }
+
+    // opaquebytes fields can only be reached through the record's bytes, so
+    // copy each one out into a local first
+    std::string field_reads;
+    for (const auto& field : method.inline_fields) {
+        field_reads += fmt::format(
+            "    {0} self_{1};\n"
+            "    memcpy(&self_{1}, self->_private + {2}, sizeof(self_{1}));\n",
+            field.c_type, field.name, field.offset);
+    }
+
+    return fmt::format(R"#(static inline {} {}_inline({}) {{
+{}    return {};
+}}
+)#",
+                       method.return_type.create_c_declaration(),
+                       method.c_qname, ps::join(", ", param_decls),
+                       field_reads, method.inline_expression);
+}
+
+std::string Record::get_method_attributes(const Method& method) const {
+    const bool allocates =
+        method.is_constructor && kind == RecordKind::OpaquePtr;
+    return get_c_attributes(method, !method.is_static && !allocates,
+                            method.is_const, allocates);
+}
+
+bool Record::can_batch_method(const Method& method) const {
+    return method.can_batch() &&
+           (method.is_static || kind != RecordKind::OpaquePtr);
+}
+
+std::string Record::get_method_batch_declaration(const Method& method) const {
+    std::vector<std::string> param_decls =
+        get_batch_param_declarations(method);
+    if (!method.is_static) {
+        param_decls.insert(param_decls.begin(),
+                           fmt::format("{}{}* self",
+                                       method.is_const ? "const " : "",
+                                       c_qname));
+    }
+
+    return fmt::format("void {}_batch({})", method.c_qname,
+                       ps::join(", ", param_decls));
+}
+
+std::string
+Record::get_method_batch_definition(const Method& method,
+                                    const std::string& declaration) const {
+    std::string call_prefix;
+    if (method.is_static) {
+        call_prefix = cpp_qname + "::" + method.cpp_name;
+    } else if (method.is_constructor) {
+        call_prefix = "new (self + _i) " + cpp_qname;
+    } else {
+        call_prefix = "to_cpp(self + _i)->" + method.cpp_name;
+    }
+
+    return fmt::format(
+        "{} {{\n{}\n}}", declaration,
+        get_exception_safe_body(method, declaration,
+                                get_batch_body(method, call_prefix)));
+}
+
 std::string
 Record::get_operator_body(const Method& method, const std::string& declaration,
                           const std::vector<std::string>& call_params) const {
@@ -164,23 +308,35 @@ Record::get_method_definition(const Method& method,
     }
 
     if (method.is_constructor && kind == RecordKind::OpaquePtr) {
-        body = get_opaqueptr_constructor_body(call_params);
+        body = get_opaqueptr_constructor_body(
+            call_params, options.catch_exceptions && !method.is_noexcept);
     } else if (method.is_constructor && (kind == RecordKind::ValueType ||
                                          kind == RecordKind::OpaqueBytes)) {
         body = get_valuetype_constructor_body(call_params);
-    } else if (method.is_copy_assignment) {
+    } else if (method.is_copy_assignment || method.is_move_assignment) {
         body = "    *to_cpp(self) = ";
         body += call_params[0] + ";\n    return self;";
     } else if (method.is_operator) {
         body = get_operator_body(method, declaration, call_params);
+    } else if (is_string_view(method.return_type) &&
+               !method.return_type.is_ref && !method.return_type.is_ptr) {
+        body = get_return_string_view_body(method, call_prefix, call_params);
+    } else if (method.return_type.type.name == "basic_string" &&
+               method.return_type.is_ref && options.owned_strings) {
+        body = get_return_string_view_body(method, call_prefix, call_params);
     } else if (method.return_type.type.name == "basic_string" &&
                method.return_type.is_ref) {
         body = get_return_string_ref_body(method, call_prefix, call_params);
+    } else if (method.return_type.type.name == "basic_string" &&
+               !method.return_type.is_ref && options.owned_strings) {
+        body = get_return_string_owned_body(method, call_prefix, call_params);
     } else if (method.return_type.type.name == "basic_string" &&
                !method.return_type.is_ref) {
         body = get_return_string_copy_body(method, call_prefix, call_params);
     } else if (method.return_type.is_uptr) {
         body = get_return_uniqueptr_body(method, call_prefix, call_params);
+    } else if (is_out_param_return(method.return_type)) {
+        body = get_return_out_param_body(method, call_prefix, call_params);
     } else if (const Record* record = return_var.cast_or_null<Record>()) {
         if (record->kind == RecordKind::ValueType) {
             body = get_return_valuetype_body(method, call_prefix, call_params);
@@ -190,15 +346,21 @@ Record::get_method_definition(const Method& method,
         } else {
             body = get_return_opaqueptr_body(method, call_prefix, call_params);
         }
-    } else if (return_var.is<Vector>()) {
+    } else if (return_var.is<Vector>() || return_var.is<SharedPtr>()) {
         body = get_return_opaquebytes_body(method, call_prefix, call_params);
+    } else if (return_var.is<Map>()) {
+        body = get_return_map_reference_body(method, call_prefix, call_params);
+    } else if (const SumType* sum = return_var.cast_or_null<SumType>()) {
+        body = sum->get_return_body(fmt::format("{}({})", call_prefix,
+                                                ps::join(", ", call_params)));
     } else if (method.return_type.type.name == "void") {
         body = get_return_void_body(method, call_prefix, call_params);
     } else {
         body = get_return_builtin_body(method, call_prefix, call_params);
     }
 
-    return fmt::format("{} {{\n{}\n}}", declaration, body);
+    return fmt::format("{} {{\n{}\n}}", declaration,
+                       get_exception_safe_body(method, declaration, body));
 }
 
 std::string Record::get_definition() const {
@@ -233,6 +395,104 @@ std::string Record::get_definition() const {
     return definitions;
 }
 
+// Kind code of a field for the reflection tables, one of the CPPMM_KIND_*
+// values declared in cppmm_containers.h
+const char* get_reflection_kind(const QualifiedType& qtype) {
+    if (qtype.is_ptr || qtype.is_ref || qtype.is_uptr ||
+        qtype.type.var.is<FuncProto>()) {
+        return "CPPMM_KIND_POINTER";
+    } else if (qtype.type.var.is<Enum>()) {
+        return "CPPMM_KIND_ENUM";
+    } else if (qtype.type.var.is<Record>()) {
+        return "CPPMM_KIND_RECORD";
+    } else if (!qtype.type.var.is<Builtin>()) {
+        return "CPPMM_KIND_OTHER";
+    }
+
+    const std::string& name = qtype.type.name;
+    if (name == "bool") {
+        return "CPPMM_KIND_BOOL";
+    } else if (name == "float" || name == "double" || name == "long double") {
+        return "CPPMM_KIND_FLOAT";
+    } else if (ps::startswith(name, "unsigned") || name == "char8_t" ||
+               name == "char16_t" || name == "char32_t") {
+        return "CPPMM_KIND_UINT";
+    }
+    return "CPPMM_KIND_INT";
+}
+
+std::string
+Record::get_reflection_declaration(const std::string& export_prefix) const {
+    if (!options.reflection || kind == RecordKind::OpaquePtr) {
+        return "";
+    }
+
+    return fmt::format("{}extern const cppmm_record_info cppmm_reflect_{};\n\n",
+                       export_prefix, c_qname);
+}
+
+std::string Record::get_reflection_definition() const {
+    if (!options.reflection || kind == RecordKind::OpaquePtr) {
+        return "";
+    }
+
+    std::vector<std::string> entries;
+    for (size_t i = 0; i < fields.size() && i < field_layouts.size(); ++i) {
+        // bitfields don't start on a byte so can't be reached through an
+        // offset
+        if (field_layouts[i].is_bitfield) {
+            continue;
+        }
+
+        const QualifiedType& qtype = fields[i].qtype;
+        std::string type_name = "NULL";
+        if (qtype.type.var.is<Enum>() || qtype.type.var.is<Record>()) {
+            type_name = fmt::format("\"{}\"", qtype.type.get_c_qname());
+        }
+        uint64_t count = 1;
+        for (const auto extent : qtype.array_extents) {
+            count *= extent;
+        }
+        entries.push_back(fmt::format("    {{\"{}\", {}, {}, {}, {}, {}}},\n",
+                                      fields[i].name, field_layouts[i].offset,
+                                      field_layouts[i].size,
+                                      get_reflection_kind(qtype), type_name,
+                                      count));
+    }
+
+    std::string result;
+    std::string fields_table = "NULL";
+    if (!entries.empty()) {
+        // C doesn't allow empty arrays
+        result = fmt::format(
+            "static const cppmm_field_info cppmm_reflect_{}_fields[] = {{\n"
+            "{}}};\n",
+            c_qname, ps::join("", entries));
+        fields_table = fmt::format("cppmm_reflect_{}_fields", c_qname);
+    }
+
+    result += fmt::format("const cppmm_record_info cppmm_reflect_{0} = "
+                          "{{\"{0}\", {1}, {2}, {3}, {4}}};\n\n",
+                          c_qname, size, alignment, fields_table,
+                          entries.size());
+    return result;
+}
+
+std::string Record::get_constant_declarations() const {
+    std::string result;
+    for (const auto& constant : constants) {
+        QualifiedType value_type = constant.qtype;
+        value_type.is_const = false;
+        result += fmt::format("static const {} {}_{}_value = {};\n",
+                              value_type.create_c_declaration(), c_qname,
+                              constant.name, constant.value);
+    }
+    if (!result.empty()) {
+        result += "\n";
+    }
+    return result;
+}
+
 std::string
 Record::get_declaration(std::set<std::string>& casts_macro_invocations) const {
     std::string declarations;
@@ -249,8 +509,13 @@ Record::get_declaration(std::set<std::string>& casts_macro_invocations) const {
         declarations += fmt::format("typedef struct {{\n");
 
         for (const auto& field : fields) {
-            declarations +=
-                fmt::format("    {} {};\n", field.qtype.type.name, field.name);
+            std::string extents;
+            for (const auto extent : field.qtype.array_extents) {
+                extents += fmt::format("[{}]", extent);
+            }
+            declarations += fmt::format("    {} {}{};\n",
+                                        field.qtype.create_c_declaration(),
+                                        field.name, extents);
         }
         declarations += fmt::format("}} {};\n\n", c_qname);
     }
@@ -9,6 +9,21 @@
 #include "param.hpp"
 
 namespace cppmm {
+// Where a field lives in its record, in bytes
+struct FieldLayout {
+    size_t offset;
+    size_t size;
+    bool is_bitfield;
+};
+
+// A static constexpr data member of a record, evaluated for -constant-values
+struct ConstantMember {
+    std::string name;
+    QualifiedType qtype;
+    // as a C initializer
+    std::string value;
+};
+
 struct Record {
     std::string cpp_name;
     std::vector<std::string> namespaces;
@@ -16,9 +31,20 @@ struct Record {
     RecordKind kind;
     std::string filename;
     std::vector<cppmm::Param> fields;
+    // public fields of an opaque record that C can read and write by value
+    // through generated accessors. Only filled in with -field-accessors
+    std::vector<cppmm::Param> accessor_fields;
+    // layouts of fields, in the same order. Only filled in with -reflection
+    std::vector<FieldLayout> field_layouts;
+    // public static constexpr data members of builtin, enum or
+    // non-OpaquePtr record type. Only filled in with -constant-values
+    std::vector<ConstantMember> constants;
     std::unordered_map<std::string, Method> methods;
     size_t size;
     size_t alignment;
+    // trivially copyable and default constructible in C++, so arrays of it
+    // can be memcpy'd and resized
+    bool is_trivial;
     std::string cpp_qname;
     std::string c_qname;
 
@@ -38,8 +64,16 @@ struct Record {
         const std::string& c_method_name,
         const std::vector<std::string>& param_decls) const;
 
+    // may_throw frees the storage again if the constructor throws
     std::string get_opaqueptr_constructor_body(
-        const std::vector<std::string>& call_params) const;
+        const std::vector<std::string>& call_params, bool may_throw) const;
+
+    std::string
+    get_construct_at_declaration(const Method& constructor) const;
+
+    std::string
+    get_construct_at_definition(const Method& constructor,
+                                const std::string& declaration) const;
 
     std::string get_valuetype_constructor_body(
         const std::vector<std::string>& call_params) const;
@@ -55,6 +89,33 @@ struct Record {
     std::string get_method_definition(const Method& method,
                                       const std::string& declaration) const;
 
+    // Get a static inline <method>_inline that evaluates the method's
+    // inline_expression directly, or an empty string if it has none
+    std::string get_method_inline_definition(const Method& method) const;
+
+    // see get_c_attributes()
+    std::string get_method_attributes(const Method& method) const;
+
+    // Batch variants of methods take an array of selves, so only work for
+    // records we can store contiguously (and for static methods)
+    bool can_batch_method(const Method& method) const;
+
+    std::string get_method_batch_declaration(const Method& method) const;
+
+    std::string
+    get_method_batch_definition(const Method& method,
+                                const std::string& declaration) const;
+
+    // Get the extern declaration of the record's -reflection table, or an
+    // empty string if reflection is off or the record is an OpaquePtr
+    std::string
+    get_reflection_declaration(const std::string& export_prefix) const;
+    // Get the definition of that table and its static const field array
+    std::string get_reflection_definition() const;
+
+    // Get static const <record>_<member>_value declarations of constants
+    std::string get_constant_declarations() const;
+
     std::string get_definition() const;
     std::string
     get_declaration(std::set<std::string>& casts_macro_invocations) const;
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+
+#include "type.hpp"
+
+
+namespace cppmm {
+
+struct SharedPtr {
+    QualifiedType element_type;
+    std::string c_qname;
+
+    std::string create_casts() const {
+        return fmt::format(
+            "CPPMM_DEFINE_POINTER_CASTS(std::shared_ptr<{}>, {});\n",
+            element_type.type.get_cpp_qname(), c_qname);
+    }
+};
+
+} // namespace cppmm
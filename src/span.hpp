@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+#include "type.hpp"
+
+namespace cppmm {
+
+// A span<T> (OIIO's or std::span) parameter. It has no C type of its own:
+// it's passed as a (T* name, size_t name_len) pair and the span is
+// constructed directly over the caller's memory, so nothing is copied.
+struct Span {
+    QualifiedType element_type;
+    std::string cpp_qname;
+};
+
+} // namespace cppmm
@@ -0,0 +1,111 @@
+#include "sum_type.hpp"
+#include "enum.hpp"
+#include "record.hpp"
+
+#include "pystring.h"
+
+#include <fmt/format.h>
+
+namespace cppmm {
+
+namespace ps = pystring;
+
+namespace {
+
+// Get the statement storing expr, an alternative held by the C++ value, in
+// dst, a member of the C struct
+std::string store_alternative(const QualifiedType& qtype,
+                              const std::string& dst, const std::string& expr) {
+    if (const Record* record = qtype.type.var.cast_or_null<Record>()) {
+        if (record->kind == RecordKind::OpaqueBytes) {
+            // move it across rather than copying its bytes, so that anything
+            // it owns is handed over instead of freed along with _cpp
+            return fmt::format("new (&{}) {}(std::move({}));", dst,
+                               record->cpp_qname, expr);
+        }
+        return fmt::format("{} = bit_cast<{}>({});", dst, record->c_qname,
+                           expr);
+    } else if (qtype.type.var.is<Enum>()) {
+        return fmt::format("{} = (int){};", dst, expr);
+    }
+    return fmt::format("{} = {};", dst, expr);
+}
+
+} // namespace
+
+std::string get_sum_type_alternative_c_type(const QualifiedType& qtype) {
+    if (qtype.type.var.is<Enum>()) {
+        return "int";
+    }
+    return qtype.type.get_c_qname();
+}
+
+std::string SumType::get_declaration() const {
+    std::string fields;
+    if (is_optional) {
+        fields = fmt::format("    bool has_value;\n"
+                             "    {} value;\n",
+                             get_sum_type_alternative_c_type(alternatives[0]));
+    } else {
+        std::vector<std::string> members;
+        for (size_t i = 0; i < alternatives.size(); ++i) {
+            members.push_back(fmt::format(
+                "        {} v{};\n",
+                get_sum_type_alternative_c_type(alternatives[i]), i));
+        }
+        // index is -1 if the variant was left valueless by an exception
+        fields = fmt::format("    int index;\n"
+                             "    union {{\n"
+                             "{}"
+                             "    }} value;\n",
+                             ps::join("", members));
+    }
+
+    return fmt::format(R"#(#ifndef CPPMM_SUM_TYPE_{0}
+#define CPPMM_SUM_TYPE_{0}
+typedef struct {{
+{1}}} {0};
+#endif
+)#",
+                       c_qname, fields);
+}
+
+std::string SumType::get_return_body(const std::string& call) const {
+    if (is_optional) {
+        return fmt::format(R"#(    auto _cpp = {};
+    {} _result = {{}};
+    _result.has_value = _cpp.has_value();
+    if (_cpp.has_value()) {{
+        {}
+    }}
+    return _result;)#",
+                           call, c_qname,
+                           store_alternative(alternatives[0], "_result.value",
+                                             "*_cpp"));
+    }
+
+    std::string cases;
+    for (size_t i = 0; i < alternatives.size(); ++i) {
+        cases += fmt::format(R"#(    case {0}:
+        {1}
+        break;
+)#",
+                             i,
+                             store_alternative(
+                                 alternatives[i],
+                                 fmt::format("_result.value.v{}", i),
+                                 fmt::format("std::get<{}>(_cpp)", i)));
+    }
+
+    return fmt::format(R"#(    auto _cpp = {};
+    {} _result = {{}};
+    _result.index = _cpp.valueless_by_exception() ? -1 : (int)_cpp.index();
+    switch (_result.index) {{
+{}    default:
+        break;
+    }}
+    return _result;)#",
+                       call, c_qname, cases);
+}
+
+} // namespace cppmm
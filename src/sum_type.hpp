@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "type.hpp"
+
+namespace cppmm {
+
+// A std::optional<T> or std::variant<Ts...> return value. It's lowered to a
+// C struct holding a tag and the payload, which is filled in field by field
+// from the C++ value so it doesn't depend on how the standard library lays
+// out its types, and is returned by value without allocating. Only builtin,
+// enum, ValueType and OpaqueBytes alternatives are supported.
+struct SumType {
+    std::vector<QualifiedType> alternatives;
+    bool is_optional;
+    std::string cpp_qname;
+    std::string c_qname;
+
+    // Get the typedef of the C struct. It's guarded so that every header
+    // that uses it can declare it
+    std::string get_declaration() const;
+
+    // Get the body of a function returning the result of call as the C
+    // struct
+    std::string get_return_body(const std::string& call) const;
+};
+
+// Get the C type of one of the alternatives of a SumType
+std::string get_sum_type_alternative_c_type(const QualifiedType& qtype);
+
+} // namespace cppmm
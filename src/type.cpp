@@ -4,8 +4,13 @@
 #include <fmt/format.h>
 
 #include "enum.hpp"
+#include "func_proto.hpp"
+#include "map.hpp"
 #include "namespaces.hpp"
 #include "record.hpp"
+#include "shared_ptr.hpp"
+#include "span.hpp"
+#include "sum_type.hpp"
 #include "type.hpp"
 #include "vector.hpp"
 
@@ -21,7 +26,8 @@ bool Type::is_pod() const {
         return true;
     }
 
-    if (var.is<Vector>()) {
+    if (var.is<Vector>() || var.is<SharedPtr>() || var.is<Span>() ||
+        var.is<Map>() || var.is<SumType>()) {
         return false;
     }
 
@@ -40,10 +46,18 @@ const char* Type::get_c_qname() const {
         return record->c_qname.c_str();
     } else if (const Vector* vector = var.cast_or_null<Vector>()) {
         return vector->c_qname.c_str();
+    } else if (const SharedPtr* sptr = var.cast_or_null<SharedPtr>()) {
+        return sptr->c_qname.c_str();
     } else if (const String* str = var.cast_or_null<String>()) {
         return "string";
     } else if (const Enum* enm = var.cast_or_null<Enum>()) {
         return enm->c_qname.c_str();
+    } else if (const FuncProto* fp = var.cast_or_null<FuncProto>()) {
+        return fp->c_qname.c_str();
+    } else if (const Map* map = var.cast_or_null<Map>()) {
+        return map->c_qname.c_str();
+    } else if (const SumType* sum = var.cast_or_null<SumType>()) {
+        return sum->c_qname.c_str();
     }
     return "UNHANDLED";
 }
@@ -56,10 +70,21 @@ std::string Type::get_cpp_qname() const {
     } else if (const Vector* vector = var.cast_or_null<Vector>()) {
         return fmt::format("std::vector<{}>",
                            vector->element_type.type.get_cpp_qname());
+    } else if (const SharedPtr* sptr = var.cast_or_null<SharedPtr>()) {
+        return fmt::format("std::shared_ptr<{}>",
+                           sptr->element_type.type.get_cpp_qname());
     } else if (const String* str = var.cast_or_null<String>()) {
         return "std::string";
     } else if (const Enum* enm = var.cast_or_null<Enum>()) {
         return enm->cpp_qname;
+    } else if (const FuncProto* fp = var.cast_or_null<FuncProto>()) {
+        return fp->cpp_qname;
+    } else if (const Span* span = var.cast_or_null<Span>()) {
+        return span->cpp_qname;
+    } else if (const Map* map = var.cast_or_null<Map>()) {
+        return map->cpp_qname;
+    } else if (const SumType* sum = var.cast_or_null<SumType>()) {
+        return sum->cpp_qname;
     }
     return "UNHANDLED";
 }
@@ -72,12 +97,17 @@ std::string QualifiedType::create_c_declaration() const {
         } else {
             result += "char*";
         }
-    } else if (type.name == "string_view") {
+    } else if (type.name == "string_view" ||
+               type.name == "basic_string_view") {
         result += "const char*";
     } else if (type.name == "const char *") {
         result += "const char*";
     } else if (type.name == "void *") {
         result += "void*";
+    } else if (const FuncProto* fp = type.var.cast_or_null<FuncProto>()) {
+        // the typedef is already a pointer, and callbacks are always passed
+        // by value on the C side
+        result += fp->c_qname;
     } else {
         if (is_const) {
             result += "const ";
@@ -89,6 +119,11 @@ std::string QualifiedType::create_c_declaration() const {
             if (is_ptr || is_ref || is_uptr) {
                 result += "*";
             }
+        } else if (const SharedPtr* sptr = type.var.cast_or_null<SharedPtr>()) {
+            result += sptr->c_qname;
+            if (is_ptr || is_ref || is_uptr) {
+                result += "*";
+            }
         } else {
             result += prefix_from_namespaces(type.namespaces, "_") + type.name;
             if (is_ptr || is_ref || is_uptr) {
@@ -133,6 +168,8 @@ std::ostream& operator<<(std::ostream& os, const cppmm::QualifiedType& qtype) {
     os << qtype.type.name;
     if (qtype.is_ptr) {
         os << "*";
+    } else if (qtype.is_rref) {
+        os << "&&";
     } else if (qtype.is_ref) {
         os << "&";
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -12,15 +13,20 @@ enum RecordKind { OpaquePtr = 0, OpaqueBytes = 1, ValueType = 2 };
 class Record;
 class Enum;
 class Vector;
+class SharedPtr;
+class Span;
+class Map;
+class SumType;
 class Builtin {};
-class FuncProto {};
+class FuncProto;
 class String {};
 
 extern Builtin builtin_int;
 extern String builtin_string;
 
 struct TypeVariant
-    : public TaggedPointer<Builtin, FuncProto, Record, Enum, Vector, String> {
+    : public TaggedPointer<Builtin, FuncProto, Record, Enum, Vector, String,
+                           SharedPtr, Span, Map, SumType> {
     using TaggedPointer::TaggedPointer;
 };
 
@@ -44,8 +50,11 @@ struct QualifiedType {
     bool is_ptr = false;
     bool is_uptr = false;
     bool is_ref = false;
+    bool is_rref = false; //< is_ref is also set for rvalue references
     bool is_const = false;
     bool requires_cast = false;
+    // dimensions of a fixed-size array field, outermost first
+    std::vector<uint64_t> array_extents;
 
     bool is_pod() const { return type.is_pod(); }
     std::string create_c_declaration() const;
@@ -22,7 +22,29 @@
     ../test/containers/bind                                         \
     -o containers-c                                                 \
     --                                                              \
+    -std=c++17                                                      \
     -I/home/anders/code/cppmm/test/containers                       \
     -isystem /home/anders/packages/llvm/10.0.1/lib/clang/10.0.1/include
 
+./cppmm                                                             \
+    ../test/flags/bind                                              \
+    -o flags-c                                                      \
+    -pch                                                            \
+    -lto                                                            \
+    -shared                                                         \
+    -owned-strings                                                  \
+    -string-lengths                                                 \
+    -out-param-returns                                              \
+    -by-value-max-size=8                                            \
+    -c-attributes                                                   \
+    -constant-values                                                \
+    -inline-accessors                                               \
+    -catch-exceptions                                               \
+    -field-accessors                                                \
+    -reflection                                                     \
+    --                                                              \
+    -std=c++17                                                      \
+    -I/home/anders/code/cppmm/test/flags/bind                       \
+    -isystem /home/anders/packages/llvm/10.0.1/lib/clang/10.0.1/include
+
 ../test/diff.sh
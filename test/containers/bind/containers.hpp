@@ -1,17 +1,55 @@
 #pragma once
 
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace containers {
 
+// a minimal span, since std::span needs C++20
+template <typename T>
+class span {
+public:
+    span(T* data, size_t size) : _data(data), _size(size) {}
+    T* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    T* _data;
+    size_t _size;
+};
+
 class CustomVT {
 public:
     int a;
     int b;
 };
 
+inline bool operator<(const CustomVT& lhs, const CustomVT& rhs) {
+    return lhs.a < rhs.a || (lhs.a == rhs.a && lhs.b < rhs.b);
+}
+
+class CustomBox {
+public:
+    float weights[4];
+    CustomVT min;
+    CustomVT max;
+};
+
+template <typename T>
+class CustomVec2 {
+public:
+    T x;
+    T y;
+
+    T length_squared() const { return x * x + y * y; }
+};
+
 class CustomOB {
     int a;
 };
@@ -25,6 +63,19 @@ class CustomElement {
     int b;
 };
 
+// not trivial, so vectors of it are copied element by element
+class CustomCopied {
+public:
+    CustomCopied() : a(0) {}
+    CustomCopied(const CustomCopied& rhs) : a(rhs.a) {}
+    CustomCopied& operator=(const CustomCopied& rhs) {
+        a = rhs.a;
+        return *this;
+    }
+
+    int a;
+};
+
 class Containers {
 public:
     static void takes_const_vec_string_ref(const std::vector<std::string>& vec) {
@@ -37,6 +88,39 @@ public:
         return std::vector<std::string>{"one", "two", "three"};
     }
 
+    static void takes_vec_copied(const std::vector<CustomCopied>& vec) {}
+
+    static int sum_vts(span<const CustomVT> vts) {
+        int sum = 0;
+        for (size_t i = 0; i < vts.size(); ++i) {
+            sum += vts.data()[i].a + vts.data()[i].b;
+        }
+        return sum;
+    }
+
+    static CustomBox returns_box() { return CustomBox{}; }
+
+    static CustomVec2<float> returns_vec2f() { return CustomVec2<float>{}; }
+    static CustomVec2<int> returns_vec2i() { return CustomVec2<int>{}; }
+
+    static std::map<std::string, int> returns_map() {
+        return std::map<std::string, int>{{"one", 1}, {"two", 2}};
+    }
+
+    static std::set<CustomVT> returns_set() {
+        return std::set<CustomVT>{{1, 2}, {3, 4}};
+    }
+
+    static std::optional<CustomVT> returns_optional() {
+        return CustomVT{1, 2};
+    }
+
+    static std::variant<int, float> returns_variant() { return 1.5f; }
+
+    static std::shared_ptr<CustomOP> returns_shared_op() {
+        return std::make_shared<CustomOP>();
+    }
+
     static void takes_mut_vec_string_ref(std::vector<std::string>& vec) {
         vec.push_back("four");
         vec.push_back("five");
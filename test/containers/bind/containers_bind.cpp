@@ -15,6 +15,19 @@ namespace containers {
 class CustomVT {
 } CPPMM_VALUETYPE;
 
+class CustomBox {
+} CPPMM_VALUETYPE;
+
+template <typename T> class CustomVec2;
+
+template <> class CustomVec2<float> {
+    float length_squared() const;
+} CPPMM_VALUETYPE;
+
+template <> class CustomVec2<int> {
+    int length_squared() const;
+} CPPMM_VALUETYPE;
+
 class CustomOB {
 } CPPMM_OPAQUEBYTES;
 
@@ -24,11 +37,24 @@ class CustomOP {
 class CustomElement {
 } CPPMM_OPAQUEBYTES;
 
+class CustomCopied {
+} CPPMM_OPAQUEBYTES;
+
 class Containers {
     static void takes_const_vec_string_ref(const std::vector<std::string>& vec);
     static std::vector<std::string> returns_vec_string();
+    static std::shared_ptr<::containers::CustomOP> returns_shared_op();
+    static ::containers::CustomBox returns_box();
+    static ::containers::CustomVec2<float> returns_vec2f();
+    static ::containers::CustomVec2<int> returns_vec2i();
+    static std::map<std::string, int> returns_map();
+    static std::set<::containers::CustomVT> returns_set();
+    static std::optional<::containers::CustomVT> returns_optional();
+    static std::variant<int, float> returns_variant();
     static void takes_mut_vec_string_ref(std::vector<std::string>& vec);
     void takes_const_vec_custom_ref(const std::vector<::containers::CustomElement>& vec);
+    static void takes_vec_copied(const std::vector<::containers::CustomCopied>& vec);
+    static int sum_vts(::containers::span<const ::containers::CustomVT> vts);
     void testint(int a);
 
 } CPPMM_OPAQUEPTR;
@@ -1,21 +1,47 @@
 //
 #include "containers_bind.h"
 #include "containers.hpp"
+#include <algorithm>
 
 namespace {
 #include "casts.h"
 
 CPPMM_DEFINE_POINTER_CASTS(containers::Containers, containers_Containers)
+CPPMM_DEFINE_POINTER_CASTS(containers::CustomBox, containers_CustomBox)
+CPPMM_DEFINE_POINTER_CASTS(containers::CustomCopied, containers_CustomCopied)
 CPPMM_DEFINE_POINTER_CASTS(containers::CustomElement, containers_CustomElement)
 CPPMM_DEFINE_POINTER_CASTS(containers::CustomOP, containers_CustomOP)
+CPPMM_DEFINE_POINTER_CASTS(containers::CustomVT, containers_CustomVT)
+CPPMM_DEFINE_POINTER_CASTS(containers::CustomVec2<float>, containers_CustomVec2_float)
+CPPMM_DEFINE_POINTER_CASTS(containers::CustomVec2<int>, containers_CustomVec2_int)
+CPPMM_DEFINE_POINTER_CASTS(std::shared_ptr<containers::CustomOP>, containers_CustomOP_shared_ptr);
+CPPMM_DEFINE_POINTER_CASTS(std::vector<containers::CustomCopied>, containers_CustomCopied_vector);
 CPPMM_DEFINE_POINTER_CASTS(std::vector<containers::CustomElement>, containers_CustomElement_vector);
 CPPMM_DEFINE_POINTER_CASTS(std::vector<std::string>, cppmm_string_vector);
+typedef std::map<std::basic_string<char, std::char_traits<char>, std::allocator<char> >, int, std::less<std::basic_string<char, std::char_traits<char>, std::allocator<char> > >, std::allocator<std::pair<const std::basic_string<char, std::char_traits<char>, std::allocator<char> >, int> > > cppmm_map_string_int_type;
+CPPMM_DEFINE_POINTER_CASTS(cppmm_map_string_int_type, cppmm_map_string_int);
+typedef std::set<containers::CustomVT, std::less<containers::CustomVT>, std::allocator<containers::CustomVT> > cppmm_set_containers_CustomVT_type;
+CPPMM_DEFINE_POINTER_CASTS(cppmm_set_containers_CustomVT_type, cppmm_set_containers_CustomVT);
 
 #undef CPPMM_DEFINE_POINTER_CASTS
 }
 
 extern "C" {
 
+size_t containers_Containers_sizeof() {
+    return sizeof(containers::Containers);
+}
+
+size_t containers_Containers_alignof() {
+    return alignof(containers::Containers);
+}
+
+void containers_Containers_destruct_at(containers_Containers* self) {
+    using T = containers::Containers;
+    to_cpp(self)->~T();
+}
+
+
 void containers_CustomElement_vector_ctor(containers_CustomElement_vector* vec) {
     new (vec) std::vector<containers::CustomElement>();
 }
@@ -41,16 +67,220 @@ void containers_CustomElement_vector_get(const containers_CustomElement_vector*
 void containers_CustomElement_vector_set(containers_CustomElement_vector* vec, int index, containers_CustomElement* element) {
     (*to_cpp(vec))[index] = *to_cpp(element);
 }
+
+void containers_CustomElement_vector_reserve(containers_CustomElement_vector* vec, size_t n) {
+    to_cpp(vec)->reserve(n);
+}
+
+void containers_CustomElement_vector_resize(containers_CustomElement_vector* vec, size_t n) {
+    to_cpp(vec)->resize(n);
+}
+
+void containers_CustomElement_vector_clear(containers_CustomElement_vector* vec) {
+    to_cpp(vec)->clear();
+}
+
+void containers_CustomElement_vector_push_back(containers_CustomElement_vector* vec, const containers_CustomElement* element) {
+    to_cpp(vec)->push_back(*to_cpp(element));
+}
+
+size_t containers_CustomElement_vector_copy_to(const containers_CustomElement_vector* vec, containers_CustomElement* dst, size_t n) {
+    const std::vector<containers::CustomElement>& v = *to_cpp(vec);
+    const size_t count = std::min(n, v.size());
+    memcpy((void*)dst, (const void*)v.data(), count * sizeof(containers::CustomElement));
+    return count;
+}
+
+void containers_CustomElement_vector_copy_from(containers_CustomElement_vector* vec, const containers_CustomElement* src, size_t n) {
+    to_cpp(vec)->assign(to_cpp(src), to_cpp(src) + n);
+}
+
+void containers_CustomElement_vector_assign_range(containers_CustomElement_vector* vec, size_t offset, const containers_CustomElement* src, size_t n) {
+    std::vector<containers::CustomElement>& v = *to_cpp(vec);
+    if (v.size() < offset + n) {
+        v.resize(offset + n);
+    }
+    memcpy((void*)(v.data() + offset), (const void*)src, n * sizeof(containers::CustomElement));
+}
 static_assert(sizeof(containers::CustomElement) == sizeof(containers_CustomElement), "sizes do not match");
 static_assert(alignof(containers::CustomElement) == alignof(containers_CustomElement), "alignments do not match");
+
+static_assert(sizeof(std::shared_ptr<containers::CustomOP>) == sizeof(containers_CustomOP_shared_ptr), "sizes do not match");
+static_assert(alignof(std::shared_ptr<containers::CustomOP>) == alignof(containers_CustomOP_shared_ptr), "alignments do not match");
+
+void containers_CustomOP_shared_ptr_retain(const containers_CustomOP_shared_ptr* ptr, containers_CustomOP_shared_ptr* copy) {
+    new (copy) std::shared_ptr<containers::CustomOP>(*to_cpp(ptr));
+}
+
+void containers_CustomOP_shared_ptr_release(containers_CustomOP_shared_ptr* ptr) {
+    to_cpp(ptr)->~shared_ptr();
+}
+
+containers_CustomOP* containers_CustomOP_shared_ptr_get(const containers_CustomOP_shared_ptr* ptr) {
+    return to_c(to_cpp(ptr)->get());
+}
+
+long containers_CustomOP_shared_ptr_use_count(const containers_CustomOP_shared_ptr* ptr) {
+    return to_cpp(ptr)->use_count();
+}
+
+size_t containers_CustomOP_sizeof() {
+    return sizeof(containers::CustomOP);
+}
+
+size_t containers_CustomOP_alignof() {
+    return alignof(containers::CustomOP);
+}
+
+void containers_CustomOP_destruct_at(containers_CustomOP* self) {
+    using T = containers::CustomOP;
+    to_cpp(self)->~T();
+}
+
+
+static_assert(sizeof(cppmm_set_containers_CustomVT_type) <= sizeof(cppmm_set_containers_CustomVT), "cppmm_set_containers_CustomVT is too small");
+static_assert(alignof(cppmm_set_containers_CustomVT_type) <= alignof(cppmm_set_containers_CustomVT), "cppmm_set_containers_CustomVT is not aligned enough");
+static_assert(sizeof(cppmm_set_containers_CustomVT_type::const_iterator) <= sizeof(cppmm_set_containers_CustomVT_cursor), "cppmm_set_containers_CustomVT_cursor is too small");
+
+void cppmm_set_containers_CustomVT_ctor(cppmm_set_containers_CustomVT* map) {
+    new (map) cppmm_set_containers_CustomVT_type();
+}
+
+void cppmm_set_containers_CustomVT_dtor(const cppmm_set_containers_CustomVT* map) {
+    to_cpp(map)->~cppmm_set_containers_CustomVT_type();
+}
+
+size_t cppmm_set_containers_CustomVT_size(const cppmm_set_containers_CustomVT* map) {
+    return to_cpp(map)->size();
+}
+
+bool cppmm_set_containers_CustomVT_find(const cppmm_set_containers_CustomVT* map, const containers_CustomVT* key, cppmm_set_containers_CustomVT_cursor* cursor) {
+    const cppmm_set_containers_CustomVT_type& m = *to_cpp(map);
+    cppmm_set_containers_CustomVT_type::const_iterator it = m.find(*to_cpp(key));
+    if (it == m.end()) {
+        return false;
+    }
+    new (cursor) cppmm_set_containers_CustomVT_type::const_iterator(it);
+    return true;
+}
+
+bool cppmm_set_containers_CustomVT_begin(const cppmm_set_containers_CustomVT* map, cppmm_set_containers_CustomVT_cursor* cursor) {
+    const cppmm_set_containers_CustomVT_type& m = *to_cpp(map);
+    if (m.empty()) {
+        return false;
+    }
+    new (cursor) cppmm_set_containers_CustomVT_type::const_iterator(m.begin());
+    return true;
+}
+
+bool cppmm_set_containers_CustomVT_next(const cppmm_set_containers_CustomVT* map, cppmm_set_containers_CustomVT_cursor* cursor) {
+    cppmm_set_containers_CustomVT_type::const_iterator& it =
+        *reinterpret_cast<cppmm_set_containers_CustomVT_type::const_iterator*>(cursor);
+    return ++it != to_cpp(map)->end();
+}
+
+const containers_CustomVT* cppmm_set_containers_CustomVT_key(const cppmm_set_containers_CustomVT_cursor* cursor) {
+    const cppmm_set_containers_CustomVT_type::const_iterator& it =
+        *reinterpret_cast<const cppmm_set_containers_CustomVT_type::const_iterator*>(cursor);
+    return to_c(&*it);
+}
 static_assert(sizeof(containers::CustomVT) == sizeof(containers_CustomVT), "sizes do not match");
 static_assert(alignof(containers::CustomVT) == alignof(containers_CustomVT), "alignments do not match");
 static_assert(offsetof(containers::CustomVT, a) == offsetof(containers_CustomVT, a), "field offset does not match");
 static_assert(offsetof(containers::CustomVT, b) == offsetof(containers_CustomVT, b), "field offset does not match");
 
+static_assert(sizeof(containers::CustomBox) == sizeof(containers_CustomBox), "sizes do not match");
+static_assert(alignof(containers::CustomBox) == alignof(containers_CustomBox), "alignments do not match");
+static_assert(offsetof(containers::CustomBox, weights) == offsetof(containers_CustomBox, weights), "field offset does not match");
+static_assert(offsetof(containers::CustomBox, min) == offsetof(containers_CustomBox, min), "field offset does not match");
+static_assert(offsetof(containers::CustomBox, max) == offsetof(containers_CustomBox, max), "field offset does not match");
+
+static_assert(sizeof(containers::CustomVec2<float>) == sizeof(containers_CustomVec2_float), "sizes do not match");
+static_assert(alignof(containers::CustomVec2<float>) == alignof(containers_CustomVec2_float), "alignments do not match");
+static_assert(offsetof(containers::CustomVec2<float>, x) == offsetof(containers_CustomVec2_float, x), "field offset does not match");
+static_assert(offsetof(containers::CustomVec2<float>, y) == offsetof(containers_CustomVec2_float, y), "field offset does not match");
+
+static_assert(sizeof(containers::CustomVec2<int>) == sizeof(containers_CustomVec2_int), "sizes do not match");
+static_assert(alignof(containers::CustomVec2<int>) == alignof(containers_CustomVec2_int), "alignments do not match");
+static_assert(offsetof(containers::CustomVec2<int>, x) == offsetof(containers_CustomVec2_int, x), "field offset does not match");
+static_assert(offsetof(containers::CustomVec2<int>, y) == offsetof(containers_CustomVec2_int, y), "field offset does not match");
+
 static_assert(sizeof(containers::CustomOB) == sizeof(containers_CustomOB), "sizes do not match");
 static_assert(alignof(containers::CustomOB) == alignof(containers_CustomOB), "alignments do not match");
 
+
+void containers_CustomCopied_vector_ctor(containers_CustomCopied_vector* vec) {
+    new (vec) std::vector<containers::CustomCopied>();
+}
+
+void containers_CustomCopied_vector_dtor(const containers_CustomCopied_vector* vec) {
+    to_cpp(vec)->~vector();
+}
+
+int containers_CustomCopied_vector_size(const containers_CustomCopied_vector* vec) {
+    return to_cpp(vec)->size();
+}
+
+containers_CustomCopied* containers_CustomCopied_vector_data(containers_CustomCopied_vector* vec) {
+    return to_c(to_cpp(vec)->data());
+}
+
+void containers_CustomCopied_vector_get(const containers_CustomCopied_vector* vec, int index, containers_CustomCopied* element) {
+    *to_cpp(element) = (*to_cpp(vec))[index];
+}
+
+void containers_CustomCopied_vector_set(containers_CustomCopied_vector* vec, int index, containers_CustomCopied* element) {
+    (*to_cpp(vec))[index] = *to_cpp(element);
+}
+
+void containers_CustomCopied_vector_reserve(containers_CustomCopied_vector* vec, size_t n) {
+    to_cpp(vec)->reserve(n);
+}
+
+void containers_CustomCopied_vector_clear(containers_CustomCopied_vector* vec) {
+    to_cpp(vec)->clear();
+}
+
+void containers_CustomCopied_vector_push_back(containers_CustomCopied_vector* vec, const containers_CustomCopied* element) {
+    to_cpp(vec)->push_back(*to_cpp(element));
+}
+
+size_t containers_CustomCopied_vector_copy_to(const containers_CustomCopied_vector* vec, containers_CustomCopied* dst, size_t n) {
+    const std::vector<containers::CustomCopied>& v = *to_cpp(vec);
+    const size_t count = std::min(n, v.size());
+    std::copy(v.begin(), v.begin() + count, to_cpp(dst));
+    return count;
+}
+
+void containers_CustomCopied_vector_copy_from(containers_CustomCopied_vector* vec, const containers_CustomCopied* src, size_t n) {
+    to_cpp(vec)->assign(to_cpp(src), to_cpp(src) + n);
+}
+
+void containers_CustomCopied_vector_assign_range(containers_CustomCopied_vector* vec, size_t offset, const containers_CustomCopied* src, size_t n) {
+    std::vector<containers::CustomCopied>& v = *to_cpp(vec);
+    for (size_t i = 0; i < n; ++i) {
+        if (offset + i < v.size()) {
+            v[offset + i] = to_cpp(src)[i];
+        } else {
+            v.push_back(to_cpp(src)[i]);
+        }
+    }
+}
+static_assert(sizeof(containers::CustomCopied) == sizeof(containers_CustomCopied), "sizes do not match");
+static_assert(alignof(containers::CustomCopied) == alignof(containers_CustomCopied), "alignments do not match");
+
+float containers_CustomVec2_float_length_squared(const containers_CustomVec2_float* self) {
+    return to_cpp(self)->length_squared();
+}
+
+
+
+int containers_CustomVec2_int_length_squared(const containers_CustomVec2_int* self) {
+    return to_cpp(self)->length_squared();
+}
+
+
+
 void containers_Containers_testint(containers_Containers* self, int a) {
     to_cpp(self)->testint(a);
 }
@@ -63,6 +293,18 @@ void containers_Containers_takes_const_vec_custom_ref(containers_Containers* sel
 
 
 
+void containers_Containers_takes_vec_copied(const containers_CustomCopied_vector* vec) {
+    containers::Containers::takes_vec_copied(*to_cpp(vec));
+}
+
+
+
+int containers_Containers_sum_vts(const containers_CustomVT* vts, size_t vts_len) {
+    return containers::Containers::sum_vts(containers::span<const containers::CustomVT>(reinterpret_cast<const containers::CustomVT*>(vts), vts_len));
+}
+
+
+
 void containers_Containers_takes_mut_vec_string_ref(cppmm_string_vector* vec) {
     containers::Containers::takes_mut_vec_string_ref(*to_cpp(vec));
 }
@@ -84,5 +326,75 @@ cppmm_string_vector containers_Containers_returns_vec_string() {
 
 
 
+containers_CustomOP_shared_ptr containers_Containers_returns_shared_op() {
+    std::shared_ptr<containers::CustomOP> tmp = containers::Containers::returns_shared_op();
+    containers_CustomOP_shared_ptr ret;
+    new (&ret) std::shared_ptr<containers::CustomOP>(std::move(tmp));
+    return ret;
+}
+
+
+
+containers_CustomBox containers_Containers_returns_box() {
+    return bit_cast<containers_CustomBox>(containers::Containers::returns_box());
+}
+
+
+
+containers_CustomVec2_float containers_Containers_returns_vec2f() {
+    return bit_cast<containers_CustomVec2_float>(containers::Containers::returns_vec2f());
+}
+
+
+
+containers_CustomVec2_int containers_Containers_returns_vec2i() {
+    return bit_cast<containers_CustomVec2_int>(containers::Containers::returns_vec2i());
+}
+
+
+
+void containers_Containers_returns_map(cppmm_map_string_int* _result) {
+    new (_result) std::map<std::basic_string<char, std::char_traits<char>, std::allocator<char> >, int, std::less<std::basic_string<char, std::char_traits<char>, std::allocator<char> > >, std::allocator<std::pair<const std::basic_string<char, std::char_traits<char>, std::allocator<char> >, int> > >(containers::Containers::returns_map());
+}
+
+
+
+void containers_Containers_returns_set(cppmm_set_containers_CustomVT* _result) {
+    new (_result) std::set<containers::CustomVT, std::less<containers::CustomVT>, std::allocator<containers::CustomVT> >(containers::Containers::returns_set());
+}
+
+
+
+cppmm_optional_containers_CustomVT containers_Containers_returns_optional() {
+    auto _cpp = containers::Containers::returns_optional();
+    cppmm_optional_containers_CustomVT _result = {};
+    _result.has_value = _cpp.has_value();
+    if (_cpp.has_value()) {
+        _result.value = bit_cast<containers_CustomVT>(*_cpp);
+    }
+    return _result;
+}
+
+
+
+cppmm_variant_int_float containers_Containers_returns_variant() {
+    auto _cpp = containers::Containers::returns_variant();
+    cppmm_variant_int_float _result = {};
+    _result.index = _cpp.valueless_by_exception() ? -1 : (int)_cpp.index();
+    switch (_result.index) {
+    case 0:
+        _result.value.v0 = std::get<0>(_cpp);
+        break;
+    case 1:
+        _result.value.v1 = std::get<1>(_cpp);
+        break;
+    default:
+        break;
+    }
+    return _result;
+}
+
+
+
 }
     
\ No newline at end of file
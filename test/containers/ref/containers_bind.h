@@ -17,6 +17,10 @@ extern "C" {
 
 typedef struct containers_Containers containers_Containers;
 
+size_t containers_Containers_sizeof();
+size_t containers_Containers_alignof();
+void containers_Containers_destruct_at(containers_Containers* self);
+
 typedef struct { char _private[8]; } containers_CustomElement CPPMM_ALIGN(4);
 
 typedef struct { char _private[24]; } containers_CustomElement_vector CPPMM_ALIGN(8);
@@ -28,14 +32,87 @@ containers_CustomElement* containers_CustomElement_vector_data(containers_Custom
 
 void containers_CustomElement_vector_get(const containers_CustomElement_vector* vec, int index, containers_CustomElement* element);
 void containers_CustomElement_vector_set(containers_CustomElement_vector* vec, int index, containers_CustomElement* element);
+
+void containers_CustomElement_vector_reserve(containers_CustomElement_vector* vec, size_t n);
+void containers_CustomElement_vector_resize(containers_CustomElement_vector* vec, size_t n);
+void containers_CustomElement_vector_clear(containers_CustomElement_vector* vec);
+void containers_CustomElement_vector_push_back(containers_CustomElement_vector* vec, const containers_CustomElement* element);
+size_t containers_CustomElement_vector_copy_to(const containers_CustomElement_vector* vec, containers_CustomElement* dst, size_t n);
+void containers_CustomElement_vector_copy_from(containers_CustomElement_vector* vec, const containers_CustomElement* src, size_t n);
+void containers_CustomElement_vector_assign_range(containers_CustomElement_vector* vec, size_t offset, const containers_CustomElement* src, size_t n);
 typedef struct containers_CustomOP containers_CustomOP;
 
+size_t containers_CustomOP_sizeof();
+size_t containers_CustomOP_alignof();
+void containers_CustomOP_destruct_at(containers_CustomOP* self);
+
+
+typedef struct { char _private[16]; } containers_CustomOP_shared_ptr CPPMM_ALIGN(8);
+
+void containers_CustomOP_shared_ptr_retain(const containers_CustomOP_shared_ptr* ptr, containers_CustomOP_shared_ptr* copy);
+void containers_CustomOP_shared_ptr_release(containers_CustomOP_shared_ptr* ptr);
+containers_CustomOP* containers_CustomOP_shared_ptr_get(const containers_CustomOP_shared_ptr* ptr);
+long containers_CustomOP_shared_ptr_use_count(const containers_CustomOP_shared_ptr* ptr);
 typedef struct {
     int a;
     int b;
 } containers_CustomVT;
 
+
+// Must stay where it was constructed: don't copy or move it with struct
+// assignment or memcpy
+typedef struct { char _private[64]; } cppmm_set_containers_CustomVT CPPMM_ALIGN(8);
+// A position in a cppmm_set_containers_CustomVT. Only valid until the container is modified
+typedef struct { char _private[16]; } cppmm_set_containers_CustomVT_cursor CPPMM_ALIGN(8);
+
+void cppmm_set_containers_CustomVT_ctor(cppmm_set_containers_CustomVT* map);
+void cppmm_set_containers_CustomVT_dtor(const cppmm_set_containers_CustomVT* map);
+size_t cppmm_set_containers_CustomVT_size(const cppmm_set_containers_CustomVT* map);
+bool cppmm_set_containers_CustomVT_find(const cppmm_set_containers_CustomVT* map, const containers_CustomVT* key, cppmm_set_containers_CustomVT_cursor* cursor);
+bool cppmm_set_containers_CustomVT_begin(const cppmm_set_containers_CustomVT* map, cppmm_set_containers_CustomVT_cursor* cursor);
+bool cppmm_set_containers_CustomVT_next(const cppmm_set_containers_CustomVT* map, cppmm_set_containers_CustomVT_cursor* cursor);
+const containers_CustomVT* cppmm_set_containers_CustomVT_key(const cppmm_set_containers_CustomVT_cursor* cursor);
+typedef struct {
+    float weights[4];
+    containers_CustomVT min;
+    containers_CustomVT max;
+} containers_CustomBox;
+
+typedef struct {
+    float x;
+    float y;
+} containers_CustomVec2_float;
+
+typedef struct {
+    int x;
+    int y;
+} containers_CustomVec2_int;
+
 typedef struct { char _private[4]; } containers_CustomOB CPPMM_ALIGN(4);
+typedef struct { char _private[4]; } containers_CustomCopied CPPMM_ALIGN(4);
+
+typedef struct { char _private[24]; } containers_CustomCopied_vector CPPMM_ALIGN(8);
+
+void containers_CustomCopied_vector_ctor(containers_CustomCopied_vector* vec);
+void containers_CustomCopied_vector_dtor(const containers_CustomCopied_vector* vec);
+int containers_CustomCopied_vector_size(const containers_CustomCopied_vector* vec);
+containers_CustomCopied* containers_CustomCopied_vector_data(containers_CustomCopied_vector* vec);
+
+void containers_CustomCopied_vector_get(const containers_CustomCopied_vector* vec, int index, containers_CustomCopied* element);
+void containers_CustomCopied_vector_set(containers_CustomCopied_vector* vec, int index, containers_CustomCopied* element);
+
+void containers_CustomCopied_vector_reserve(containers_CustomCopied_vector* vec, size_t n);
+void containers_CustomCopied_vector_clear(containers_CustomCopied_vector* vec);
+void containers_CustomCopied_vector_push_back(containers_CustomCopied_vector* vec, const containers_CustomCopied* element);
+size_t containers_CustomCopied_vector_copy_to(const containers_CustomCopied_vector* vec, containers_CustomCopied* dst, size_t n);
+void containers_CustomCopied_vector_copy_from(containers_CustomCopied_vector* vec, const containers_CustomCopied* src, size_t n);
+void containers_CustomCopied_vector_assign_range(containers_CustomCopied_vector* vec, size_t offset, const containers_CustomCopied* src, size_t n);
+
+
+float containers_CustomVec2_float_length_squared(const containers_CustomVec2_float* self);
+
+
+int containers_CustomVec2_int_length_squared(const containers_CustomVec2_int* self);
 
 
 void containers_Containers_testint(containers_Containers* self, int a);
@@ -44,6 +121,12 @@ void containers_Containers_testint(containers_Containers* self, int a);
 void containers_Containers_takes_const_vec_custom_ref(containers_Containers* self, const containers_CustomElement_vector* vec);
 
 
+void containers_Containers_takes_vec_copied(const containers_CustomCopied_vector* vec);
+
+
+int containers_Containers_sum_vts(const containers_CustomVT* vts, size_t vts_len);
+
+
 void containers_Containers_takes_mut_vec_string_ref(cppmm_string_vector* vec);
 
 
@@ -53,6 +136,47 @@ void containers_Containers_takes_const_vec_string_ref(const cppmm_string_vector*
 cppmm_string_vector containers_Containers_returns_vec_string();
 
 
+containers_CustomOP_shared_ptr containers_Containers_returns_shared_op();
+
+
+containers_CustomBox containers_Containers_returns_box();
+
+
+containers_CustomVec2_float containers_Containers_returns_vec2f();
+
+
+containers_CustomVec2_int containers_Containers_returns_vec2i();
+
+
+void containers_Containers_returns_map(cppmm_map_string_int* _result);
+
+
+void containers_Containers_returns_set(cppmm_set_containers_CustomVT* _result);
+
+#ifndef CPPMM_SUM_TYPE_cppmm_optional_containers_CustomVT
+#define CPPMM_SUM_TYPE_cppmm_optional_containers_CustomVT
+typedef struct {
+    bool has_value;
+    containers_CustomVT value;
+} cppmm_optional_containers_CustomVT;
+#endif
+
+cppmm_optional_containers_CustomVT containers_Containers_returns_optional();
+
+#ifndef CPPMM_SUM_TYPE_cppmm_variant_int_float
+#define CPPMM_SUM_TYPE_cppmm_variant_int_float
+typedef struct {
+    int index;
+    union {
+        int v0;
+        float v1;
+    } value;
+} cppmm_variant_int_float;
+#endif
+
+cppmm_variant_int_float containers_Containers_returns_variant();
+
+
 #undef CPPMM_ALIGN
 
 #ifdef __cplusplus
@@ -1,19 +1,67 @@
 
 #include "cppmm_containers.h"
+#include <algorithm>
+#include <new>
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace {
 #include "casts.h"
 
+typedef std::map<std::basic_string<char, std::char_traits<char>, std::allocator<char> >, int, std::less<std::basic_string<char, std::char_traits<char>, std::allocator<char> > >, std::allocator<std::pair<const std::basic_string<char, std::char_traits<char>, std::allocator<char> >, int> > > cppmm_map_string_int_type;
+CPPMM_DEFINE_POINTER_CASTS(cppmm_map_string_int_type, cppmm_map_string_int);
+
 CPPMM_DEFINE_POINTER_CASTS(std::vector<std::string>, cppmm_string_vector);
+CPPMM_DEFINE_POINTER_CASTS(std::string, cppmm_string);
+
+// cppmm_string is sized to hold std::string from both libstdc++ and libc++
+static_assert(sizeof(std::string) <= sizeof(cppmm_string),
+              "cppmm_string is too small for std::string");
+static_assert(alignof(std::string) <= alignof(cppmm_string),
+              "cppmm_string is not aligned enough for std::string");
 
+// Over-aligned requests need the aligned operator new, which is only there
+// from C++17
+void* default_allocate(size_t size, size_t alignment, void* user_data) {
+#if __cpp_aligned_new
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+#endif
+    return ::operator new(size);
+}
+
+void default_deallocate(void* ptr, size_t size, size_t alignment, void* user_data) {
+#if __cpp_aligned_new
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        ::operator delete(ptr, std::align_val_t(alignment));
+        return;
+    }
+#endif
+    ::operator delete(ptr);
+}
+
+cppmm_allocate_fn allocate_fn = default_allocate;
+cppmm_deallocate_fn deallocate_fn = default_deallocate;
+void* allocator_user_data = nullptr;
 
 #undef CPPMM_DEFINE_POINTER_CASTS
 }
 
 extern "C" {
 
+void cppmm_string_vector_ctor(cppmm_string_vector* vec) {
+    new (vec) std::vector<std::string>();
+}
+
+void cppmm_string_vector_dtor(const cppmm_string_vector* vec) {
+    to_cpp(vec)->~vector();
+}
+
 const char* cppmm_string_vector_get(const cppmm_string_vector* vec, int index) {
     return (*to_cpp(vec))[index].c_str();
 }
@@ -22,5 +70,141 @@ int cppmm_string_vector_size(const cppmm_string_vector* vec) {
     return to_cpp(vec)->size();
 }
 
+void cppmm_string_vector_packed_size(const cppmm_string_vector* vec, size_t* bytes_len, size_t* offsets_len) {
+    const std::vector<std::string>& v = *to_cpp(vec);
+    size_t total = 0;
+    for (const auto& s : v) {
+        total += s.size();
+    }
+    *bytes_len = total;
+    *offsets_len = v.size() + 1;
+}
+
+bool cppmm_string_vector_export(const cppmm_string_vector* vec, char* bytes, size_t bytes_len, size_t* offsets, size_t offsets_len) {
+    const std::vector<std::string>& v = *to_cpp(vec);
+    if (offsets_len < v.size() + 1) {
+        return false;
+    }
+
+    size_t total = 0;
+    for (const auto& s : v) {
+        total += s.size();
+    }
+    if (bytes_len < total) {
+        return false;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < v.size(); ++i) {
+        offsets[i] = offset;
+        memcpy(bytes + offset, v[i].data(), v[i].size());
+        offset += v[i].size();
+    }
+    offsets[v.size()] = offset;
+    return true;
+}
+
+void cppmm_string_vector_import(cppmm_string_vector* vec, const char* bytes, const size_t* offsets, size_t count) {
+    std::vector<std::string>& v = *to_cpp(vec);
+    v.clear();
+    v.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        v.emplace_back(bytes + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+}
+
+void cppmm_string_dtor(cppmm_string* str) {
+    using std::string;
+    to_cpp(str)->~string();
+}
+
+const char* cppmm_string_c_str(const cppmm_string* str) {
+    return to_cpp(str)->c_str();
+}
+
+size_t cppmm_string_size(const cppmm_string* str) {
+    return to_cpp(str)->size();
+}
+
+cppmm_string_view cppmm_string_as_view(const cppmm_string* str) {
+    const std::string& s = *to_cpp(str);
+    return cppmm_string_view{s.data(), s.size()};
+}
+
+void cppmm_set_allocator(cppmm_allocate_fn allocate, cppmm_deallocate_fn deallocate, void* user_data) {
+    if (allocate == nullptr && deallocate == nullptr) {
+        allocate_fn = default_allocate;
+        deallocate_fn = default_deallocate;
+        allocator_user_data = nullptr;
+    } else {
+        allocate_fn = allocate;
+        deallocate_fn = deallocate;
+        allocator_user_data = user_data;
+    }
+}
+
+void* cppmm_allocate(size_t size, size_t alignment) {
+    return allocate_fn(size, alignment, allocator_user_data);
+}
+
+void cppmm_deallocate(void* ptr, size_t size, size_t alignment) {
+    deallocate_fn(ptr, size, alignment, allocator_user_data);
+}
+
+
+static_assert(sizeof(cppmm_map_string_int_type) <= sizeof(cppmm_map_string_int), "cppmm_map_string_int is too small");
+static_assert(alignof(cppmm_map_string_int_type) <= alignof(cppmm_map_string_int), "cppmm_map_string_int is not aligned enough");
+static_assert(sizeof(cppmm_map_string_int_type::const_iterator) <= sizeof(cppmm_map_string_int_cursor), "cppmm_map_string_int_cursor is too small");
+
+void cppmm_map_string_int_ctor(cppmm_map_string_int* map) {
+    new (map) cppmm_map_string_int_type();
+}
+
+void cppmm_map_string_int_dtor(const cppmm_map_string_int* map) {
+    to_cpp(map)->~cppmm_map_string_int_type();
+}
+
+size_t cppmm_map_string_int_size(const cppmm_map_string_int* map) {
+    return to_cpp(map)->size();
+}
+
+bool cppmm_map_string_int_find(const cppmm_map_string_int* map, const char* key, size_t key_len, cppmm_map_string_int_cursor* cursor) {
+    const cppmm_map_string_int_type& m = *to_cpp(map);
+    cppmm_map_string_int_type::const_iterator it = m.find(std::string(key, key_len));
+    if (it == m.end()) {
+        return false;
+    }
+    new (cursor) cppmm_map_string_int_type::const_iterator(it);
+    return true;
+}
+
+bool cppmm_map_string_int_begin(const cppmm_map_string_int* map, cppmm_map_string_int_cursor* cursor) {
+    const cppmm_map_string_int_type& m = *to_cpp(map);
+    if (m.empty()) {
+        return false;
+    }
+    new (cursor) cppmm_map_string_int_type::const_iterator(m.begin());
+    return true;
+}
+
+bool cppmm_map_string_int_next(const cppmm_map_string_int* map, cppmm_map_string_int_cursor* cursor) {
+    cppmm_map_string_int_type::const_iterator& it =
+        *reinterpret_cast<cppmm_map_string_int_type::const_iterator*>(cursor);
+    return ++it != to_cpp(map)->end();
+}
+
+cppmm_string_view cppmm_map_string_int_key(const cppmm_map_string_int_cursor* cursor) {
+    const cppmm_map_string_int_type::const_iterator& it =
+        *reinterpret_cast<const cppmm_map_string_int_type::const_iterator*>(cursor);
+    const std::string& s = it->first;
+    return cppmm_string_view{s.data(), s.size()};
+}
+
+const int* cppmm_map_string_int_value(const cppmm_map_string_int_cursor* cursor) {
+    const cppmm_map_string_int_type::const_iterator& it =
+        *reinterpret_cast<const cppmm_map_string_int_type::const_iterator*>(cursor);
+    return &it->second;
+}
+
 }
     
\ No newline at end of file
@@ -3,3 +3,4 @@
 diff half-c ../test/half/ref
 diff oiio_min-c ../test/oiio_min/ref
 diff containers-c ../test/containers/ref
+diff flags-c ../test/flags/ref
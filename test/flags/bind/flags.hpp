@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+namespace flags {
+
+enum class Channel { R, G, B };
+
+// a valuetype with a constant and a method that can be translated to C
+class Color {
+public:
+    float r;
+    float g;
+    float b;
+
+    static constexpr int channels = 3;
+
+    float sum() const { return r + g + b; }
+};
+
+// an opaquebytes record whose accessor reads a private field
+class Half16 {
+public:
+    Half16() noexcept : _h(0) {}
+
+    static constexpr unsigned short max_bits = 0x7bff;
+
+    static Half16 from_bits(unsigned short bits) noexcept {
+        Half16 h;
+        h._h = bits;
+        return h;
+    }
+
+    unsigned short bits() const noexcept { return _h; }
+    bool equals(const Half16& other) const noexcept { return _h == other._h; }
+
+private:
+    unsigned short _h;
+};
+
+// an opaqueptr record with strings, public fields and a method that throws
+class Image {
+public:
+    Image(const std::string& name)
+        : width(0), height(0), channel(Channel::R), _name(name) {}
+
+    const std::string& name() const noexcept { return _name; }
+    std::string description() const { return _name + " image"; }
+    void set_name(const std::string& name) { _name = name; }
+    void resize(int w, int h) {
+        if (w < 0 || h < 0) {
+            throw std::invalid_argument("negative size");
+        }
+        width = w;
+        height = h;
+    }
+
+    int width;
+    int height;
+    Channel channel;
+
+private:
+    std::string _name;
+};
+
+constexpr int version() noexcept { return 3; }
+
+inline Color gray(float v) noexcept { return Color{v, v, v}; }
+
+} // namespace flags
@@ -0,0 +1,40 @@
+#include "flags.hpp"
+
+#define CPPMM_IGNORE __attribute__((annotate("cppmm:ignore")))
+#define CPPMM_RENAME(x) __attribute__((annotate("cppmm:rename:" #x)))
+
+#define CPPMM_OPAQUEPTR __attribute__((annotate("cppmm:opaqueptr")))
+#define CPPMM_OPAQUEBYTES __attribute__((annotate("cppmm:opaquebytes")))
+#define CPPMM_VALUETYPE __attribute__((annotate("cppmm:valuetype")))
+
+namespace cppmm_bind {
+
+namespace flags {
+
+enum class Channel {};
+
+class Color {
+    float sum() const;
+} CPPMM_VALUETYPE;
+
+class Half16 {
+    Half16() noexcept CPPMM_RENAME(ctor);
+    static ::flags::Half16 from_bits(unsigned short bits) noexcept;
+    unsigned short bits() const noexcept;
+    bool equals(const ::flags::Half16& other) const noexcept;
+} CPPMM_OPAQUEBYTES;
+
+class Image {
+    Image(const std::string& name) CPPMM_RENAME(new);
+    const std::string& name() const noexcept;
+    std::string description() const;
+    void set_name(const std::string& name);
+    void resize(int w, int h);
+} CPPMM_OPAQUEPTR;
+
+int version() noexcept;
+::flags::Color gray(float v) noexcept;
+
+} // namespace flags
+
+} // namespace cppmm_bind
@@ -0,0 +1,151 @@
+
+#pragma once
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+#define CPPMM_ALIGN(x) __declspec(align(x))
+#else
+#define CPPMM_ALIGN(x) __attribute__((aligned(x)))
+#endif
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+#ifdef CPPMM_EXPORTS
+#define CPPMM_API __declspec(dllexport)
+#else
+#define CPPMM_API __declspec(dllimport)
+#endif
+#else
+#define CPPMM_API __attribute__((visibility("default")))
+#endif
+
+
+typedef struct { char _private[24]; } cppmm_string_vector CPPMM_ALIGN(8);
+
+CPPMM_API void cppmm_string_vector_ctor(cppmm_string_vector* vec);
+CPPMM_API void cppmm_string_vector_dtor(const cppmm_string_vector* vec);
+CPPMM_API const char* cppmm_string_vector_get(const cppmm_string_vector* vec, int index);
+CPPMM_API int cppmm_string_vector_size(const cppmm_string_vector* vec);
+
+// Packed format for moving a whole vector of strings in one call: the strings
+// are concatenated without terminators into bytes, and string i is
+// bytes[offsets[i], offsets[i+1]), so offsets has one more entry than there are
+// strings.
+CPPMM_API void cppmm_string_vector_packed_size(const cppmm_string_vector* vec, size_t* bytes_len, size_t* offsets_len);
+// Returns false, writing nothing, if either buffer is too small
+CPPMM_API bool cppmm_string_vector_export(const cppmm_string_vector* vec, char* bytes, size_t bytes_len, size_t* offsets, size_t offsets_len);
+// Replaces the contents of vec with the count strings packed in bytes
+CPPMM_API void cppmm_string_vector_import(cppmm_string_vector* vec, const char* bytes, const size_t* offsets, size_t count);
+
+// A borrowed, not necessarily NUL-terminated, string. Only valid for as long
+// as the object it was returned from.
+typedef struct {
+    const char* ptr;
+    size_t len;
+} cppmm_string_view;
+
+// An owned std::string that a function has moved its result into. Must be
+// destroyed with cppmm_string_dtor() and must not be copied bitwise.
+typedef struct { char _private[32]; } cppmm_string CPPMM_ALIGN(8);
+
+CPPMM_API void cppmm_string_dtor(cppmm_string* str);
+CPPMM_API const char* cppmm_string_c_str(const cppmm_string* str);
+CPPMM_API size_t cppmm_string_size(const cppmm_string* str);
+CPPMM_API cppmm_string_view cppmm_string_as_view(const cppmm_string* str);
+
+// Allocator used for every OpaquePtr object the library creates with a _new()
+// style constructor. Defaults to the global operator new/delete. Passing NULL
+// for both functions restores the default.
+typedef void* (*cppmm_allocate_fn)(size_t size, size_t alignment, void* user_data);
+typedef void (*cppmm_deallocate_fn)(void* ptr, size_t size, size_t alignment, void* user_data);
+
+CPPMM_API void cppmm_set_allocator(cppmm_allocate_fn allocate, cppmm_deallocate_fn deallocate, void* user_data);
+CPPMM_API void* cppmm_allocate(size_t size, size_t alignment);
+CPPMM_API void cppmm_deallocate(void* ptr, size_t size, size_t alignment);
+
+// Error codes for exceptions caught before they reach C
+enum {
+    CPPMM_ERROR_NONE = 0,
+    CPPMM_ERROR_BAD_ALLOC = 1,
+    CPPMM_ERROR_EXCEPTION = 2,
+    CPPMM_ERROR_UNKNOWN = 3,
+};
+
+// When a function that is not noexcept throws, the exception is recorded for
+// the calling thread and the function returns a zero value. Successful calls
+// don't reset the record, so clear it before a sequence of calls and check it
+// afterwards. Reading it never allocates, and the message is valid until the
+// next error on the same thread.
+//
+// Only the bound functions are wrapped. The generated helpers (the vector,
+// string vector, map and shared_ptr functions and the field accessors) don't
+// catch anything, so an allocation failure in them still unwinds into C.
+CPPMM_API int cppmm_error_code();
+CPPMM_API const char* cppmm_error_message();
+CPPMM_API void cppmm_clear_error();
+
+#ifdef __cplusplus
+// Records the exception currently being handled. Only for use by the
+// generated wrappers, from inside a catch block
+void cppmm_set_error_from_current_exception();
+#endif
+
+// Reflection tables. Every bound valuetype and opaquebytes record has an
+// extern const cppmm_record_info cppmm_reflect_<record>, and every enum a
+// cppmm_enum_info cppmm_reflect_<enum>, declared in its header and defined
+// once in the library. Offsets and sizes are in bytes, so fields can be read
+// and written directly through memory.
+enum {
+    CPPMM_KIND_BOOL = 0,
+    CPPMM_KIND_INT = 1,
+    CPPMM_KIND_UINT = 2,
+    CPPMM_KIND_FLOAT = 3,
+    CPPMM_KIND_ENUM = 4,
+    CPPMM_KIND_RECORD = 5,
+    CPPMM_KIND_POINTER = 6,
+    // a C++ type with no C representation, such as a std::vector
+    CPPMM_KIND_OTHER = 7,
+};
+
+typedef struct {
+    const char* name;
+    size_t offset;
+    // of the whole field, so for arrays of all count elements
+    size_t size;
+    int kind;
+    // the C name of the field's record or enum type, or NULL
+    const char* type_name;
+    // the number of elements for fixed-size arrays, otherwise 1
+    size_t count;
+} cppmm_field_info;
+
+typedef struct {
+    const char* name;
+    size_t size;
+    size_t alignment;
+    const cppmm_field_info* fields;
+    size_t field_count;
+} cppmm_record_info;
+
+typedef struct {
+    const char* name;
+    long long value;
+} cppmm_enumerator_info;
+
+typedef struct {
+    const char* name;
+    const cppmm_enumerator_info* enumerators;
+    size_t enumerator_count;
+} cppmm_enum_info;
+
+#undef CPPMM_API
+
+#ifdef __cplusplus
+}
+#endif
+    
\ No newline at end of file
@@ -0,0 +1,224 @@
+//
+#include "flags_bind.h"
+#include "flags.hpp"
+#include <algorithm>
+
+namespace {
+#include "casts.h"
+
+CPPMM_DEFINE_POINTER_CASTS(flags::Color, flags_Color)
+CPPMM_DEFINE_POINTER_CASTS(flags::Half16, flags_Half16)
+CPPMM_DEFINE_POINTER_CASTS(flags::Image, flags_Image)
+
+#undef CPPMM_DEFINE_POINTER_CASTS
+}
+
+#if defined(__clang__)
+#define CPPMM_LTO_INLINE __attribute__((always_inline))
+#else
+#define CPPMM_LTO_INLINE
+#endif
+
+extern "C" {
+
+size_t flags_Image_sizeof() {
+    return sizeof(flags::Image);
+}
+
+size_t flags_Image_alignof() {
+    return alignof(flags::Image);
+}
+
+void flags_Image_destruct_at(flags_Image* self) {
+    using T = flags::Image;
+    to_cpp(self)->~T();
+}
+
+void flags_Image_destroy(flags_Image* self) {
+    using T = flags::Image;
+    to_cpp(self)->~T();
+    cppmm_deallocate(self, sizeof(T), alignof(T));
+}
+
+
+int flags_Image_get_width(const flags_Image* self) {
+    return to_cpp(self)->width;
+}
+
+void flags_Image_set_width(flags_Image* self, int value) {
+    to_cpp(self)->width = value;
+}
+
+int flags_Image_get_height(const flags_Image* self) {
+    return to_cpp(self)->height;
+}
+
+void flags_Image_set_height(flags_Image* self, int value) {
+    to_cpp(self)->height = value;
+}
+
+int flags_Image_get_channel(const flags_Image* self) {
+    return (int)to_cpp(self)->channel;
+}
+
+void flags_Image_set_channel(flags_Image* self, int value) {
+    to_cpp(self)->channel = (flags::Channel)value;
+}
+
+void flags_Image_snapshot(const flags_Image* self, flags_Image_fields* out) {
+    out->width = to_cpp(self)->width;
+    out->height = to_cpp(self)->height;
+    out->channel = (int)to_cpp(self)->channel;
+}
+
+void flags_Image_apply(flags_Image* self, const flags_Image_fields* fields) {
+    to_cpp(self)->width = fields->width;
+    to_cpp(self)->height = fields->height;
+    to_cpp(self)->channel = (flags::Channel)fields->channel;
+}
+
+static const cppmm_field_info cppmm_reflect_flags_Half16_fields[] = {
+    {"_h", 0, 2, CPPMM_KIND_UINT, NULL, 1},
+};
+const cppmm_record_info cppmm_reflect_flags_Half16 = {"flags_Half16", 2, 2, cppmm_reflect_flags_Half16_fields, 1};
+
+static_assert(sizeof(flags::Half16) == sizeof(flags_Half16), "sizes do not match");
+static_assert(alignof(flags::Half16) == alignof(flags_Half16), "alignments do not match");
+static const cppmm_field_info cppmm_reflect_flags_Color_fields[] = {
+    {"r", 0, 4, CPPMM_KIND_FLOAT, NULL, 1},
+    {"g", 4, 4, CPPMM_KIND_FLOAT, NULL, 1},
+    {"b", 8, 4, CPPMM_KIND_FLOAT, NULL, 1},
+};
+const cppmm_record_info cppmm_reflect_flags_Color = {"flags_Color", 12, 4, cppmm_reflect_flags_Color_fields, 3};
+
+static_assert(sizeof(flags::Color) == sizeof(flags_Color), "sizes do not match");
+static_assert(alignof(flags::Color) == alignof(flags_Color), "alignments do not match");
+static_assert(offsetof(flags::Color, r) == offsetof(flags_Color, r), "field offset does not match");
+static_assert(offsetof(flags::Color, g) == offsetof(flags_Color, g), "field offset does not match");
+static_assert(offsetof(flags::Color, b) == offsetof(flags_Color, b), "field offset does not match");
+
+static const cppmm_enumerator_info cppmm_reflect_flags_Channel_enumerators[] = {
+    {"R", flags_Channel_R},
+    {"G", flags_Channel_G},
+    {"B", flags_Channel_B},
+};
+const cppmm_enum_info cppmm_reflect_flags_Channel = {"flags_Channel", cppmm_reflect_flags_Channel_enumerators, 3};
+
+
+CPPMM_LTO_INLINE flags_Color flags_gray(float v) {
+    return bit_cast<flags_Color>(flags::gray(v));
+}
+
+
+
+CPPMM_LTO_INLINE int flags_version() {
+    return flags::version();
+}
+
+
+
+CPPMM_LTO_INLINE void flags_Image_resize(flags_Image* self, int w, int h) {
+    try {
+        to_cpp(self)->resize(w, h);
+    } catch (...) {
+        cppmm_set_error_from_current_exception();
+        return;
+    }
+}
+
+
+
+CPPMM_LTO_INLINE void flags_Image_set_name(flags_Image* self, const char* name, size_t name_len) {
+    try {
+        to_cpp(self)->set_name(std::string(name, name_len));
+    } catch (...) {
+        cppmm_set_error_from_current_exception();
+        return;
+    }
+}
+
+
+
+CPPMM_LTO_INLINE void flags_Image_description(const flags_Image* self, cppmm_string* _result) {
+    try {
+        new (_result) std::string(to_cpp(self)->description());
+    } catch (...) {
+        cppmm_set_error_from_current_exception();
+        return;
+    }
+}
+
+
+
+CPPMM_LTO_INLINE cppmm_string_view flags_Image_name(const flags_Image* self) {
+    auto&& result = to_cpp(self)->name();
+    return cppmm_string_view{result.data(), result.size()};
+}
+
+
+
+CPPMM_LTO_INLINE flags_Image* flags_Image_new(const char* name, size_t name_len) {
+    try {
+        void* storage = cppmm_allocate(sizeof(flags::Image), alignof(flags::Image));
+        try {
+            return to_c(new (storage) flags::Image(std::string(name, name_len)));
+        } catch (...) {
+            cppmm_deallocate(storage, sizeof(flags::Image), alignof(flags::Image));
+            throw;
+        }
+    } catch (...) {
+        cppmm_set_error_from_current_exception();
+        return {};
+    }
+}
+
+
+
+flags_Image* flags_Image_new_at(void* storage, const char* name, size_t name_len) {
+    try {
+        return to_c(new (storage) flags::Image(std::string(name, name_len)));
+    } catch (...) {
+        cppmm_set_error_from_current_exception();
+        return {};
+    }
+}
+
+
+
+CPPMM_LTO_INLINE bool flags_Half16_equals(const flags_Half16* self, flags_Half16 other) {
+    return to_cpp(self)->equals(bit_cast<flags::Half16>(other));
+}
+
+
+
+CPPMM_LTO_INLINE unsigned short flags_Half16_bits(const flags_Half16* self) {
+    return to_cpp(self)->bits();
+}
+
+
+
+CPPMM_LTO_INLINE void flags_Half16_from_bits(unsigned short bits, flags_Half16* _result) {
+    new (_result) flags::Half16(flags::Half16::from_bits(bits));
+}
+
+
+
+CPPMM_LTO_INLINE void flags_Half16_ctor(flags_Half16* self) {
+    self = to_c(new (self) flags::Half16());
+}
+
+
+
+CPPMM_LTO_INLINE float flags_Color_sum(const flags_Color* self) {
+    try {
+        return to_cpp(self)->sum();
+    } catch (...) {
+        cppmm_set_error_from_current_exception();
+        return {};
+    }
+}
+
+
+
+}
+    
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <string.h>
+#include "cppmm_containers.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+#define CPPMM_ALIGN(x) __declspec(align(x))
+#else
+#define CPPMM_ALIGN(x) __attribute__((aligned(x)))
+#endif
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+#ifdef CPPMM_EXPORTS
+#define CPPMM_API __declspec(dllexport)
+#else
+#define CPPMM_API __declspec(dllimport)
+#endif
+#else
+#define CPPMM_API __attribute__((visibility("default")))
+#endif
+
+#ifndef CPPMM_ATTRIBUTES
+#if defined(__GNUC__) || defined(__clang__)
+#define CPPMM_ATTRIBUTES(...) __attribute__((__VA_ARGS__))
+#else
+#define CPPMM_ATTRIBUTES(...)
+#endif
+#endif
+
+typedef struct flags_Image flags_Image;
+
+CPPMM_API size_t flags_Image_sizeof();
+CPPMM_API size_t flags_Image_alignof();
+CPPMM_API void flags_Image_destruct_at(flags_Image* self);
+CPPMM_API void flags_Image_destroy(flags_Image* self);
+
+typedef struct {
+    int width;
+    int height;
+    int channel;
+} flags_Image_fields;
+
+CPPMM_API int flags_Image_get_width(const flags_Image* self);
+CPPMM_API void flags_Image_set_width(flags_Image* self, int value);
+CPPMM_API int flags_Image_get_height(const flags_Image* self);
+CPPMM_API void flags_Image_set_height(flags_Image* self, int value);
+CPPMM_API int flags_Image_get_channel(const flags_Image* self);
+CPPMM_API void flags_Image_set_channel(flags_Image* self, int value);
+CPPMM_API void flags_Image_snapshot(const flags_Image* self, flags_Image_fields* out);
+CPPMM_API void flags_Image_apply(flags_Image* self, const flags_Image_fields* fields);
+
+typedef struct { char _private[2]; } flags_Half16 CPPMM_ALIGN(2);
+CPPMM_API extern const cppmm_record_info cppmm_reflect_flags_Half16;
+
+static const unsigned short flags_Half16_max_bits_value = 31743u;
+
+typedef struct {
+    float r;
+    float g;
+    float b;
+} flags_Color;
+
+CPPMM_API extern const cppmm_record_info cppmm_reflect_flags_Color;
+
+static const int flags_Color_channels_value = 3;
+
+enum flags_Channel {
+    flags_Channel_R = 0,
+    flags_Channel_G = 1,
+    flags_Channel_B = 2,
+};
+
+CPPMM_API extern const cppmm_enum_info cppmm_reflect_flags_Channel;
+
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nothrow) flags_Color flags_gray(float v);
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nothrow) int flags_version();
+static const int flags_version_value = 3;
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nonnull(1)) void flags_Image_resize(flags_Image* self, int w, int h);
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nonnull(1)) void flags_Image_set_name(flags_Image* self, const char* name, size_t name_len);
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nonnull(1)) void flags_Image_description(const flags_Image* self, cppmm_string* _result);
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nonnull(1)) cppmm_string_view flags_Image_name(const flags_Image* self);
+
+
+CPPMM_API CPPMM_ATTRIBUTES(warn_unused_result) flags_Image* flags_Image_new(const char* name, size_t name_len);
+CPPMM_API flags_Image* flags_Image_new_at(void* storage, const char* name, size_t name_len);
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nothrow, nonnull(1)) bool flags_Half16_equals(const flags_Half16* self, flags_Half16 other);
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nothrow, nonnull(1)) unsigned short flags_Half16_bits(const flags_Half16* self);
+static inline unsigned short flags_Half16_bits_inline(const flags_Half16* self) {
+    unsigned short self__h;
+    memcpy(&self__h, self->_private + 0, sizeof(self__h));
+    return self__h;
+}
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nothrow) void flags_Half16_from_bits(unsigned short bits, flags_Half16* _result);
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nothrow, nonnull(1)) void flags_Half16_ctor(flags_Half16* self);
+
+
+CPPMM_API CPPMM_ATTRIBUTES(nonnull(1)) float flags_Color_sum(const flags_Color* self);
+static inline float flags_Color_sum_inline(const flags_Color* self) {
+    return ((self->r + self->g) + self->b);
+}
+
+
+#undef CPPMM_ALIGN
+#undef CPPMM_API
+
+#ifdef __cplusplus
+}
+#endif
+    
\ No newline at end of file
@@ -3,6 +3,7 @@
 #define CPPMM_IGNORE __attribute__((annotate("cppmm:ignore")))
 #define CPPMM_RENAME(x) __attribute__((annotate("cppmm:rename:" #x)))
 #define CPPMM_OPAQUEBYTES __attribute__((annotate("cppmm:opaquebytes")))
+#define CPPMM_BATCH __attribute__((annotate("cppmm:batch")))
 
 namespace cppmm_bind {
 namespace IMATH_INTERNAL_NAMESPACE {
@@ -11,16 +12,16 @@ namespace Imath = IMATH_INTERNAL_NAMESPACE;
 
 class half {
     half() CPPMM_RENAME(ctor);
-    half(float f) CPPMM_RENAME(from_float);
+    half(float f) CPPMM_RENAME(from_float) CPPMM_BATCH;
     ~half() CPPMM_RENAME(dtor);
     half(const ::Imath::half& other) CPPMM_RENAME(copy);
-    half(::Imath::half&& other) CPPMM_IGNORE;
-    operator float() const CPPMM_RENAME(to_float);
+    half(::Imath::half&& other);
+    operator float() const CPPMM_RENAME(to_float) CPPMM_BATCH;
 
     ::Imath::half operator-() const CPPMM_RENAME(neg);
     // ::Imath::half operator-() const CPPMM_IGNORE;
     ::Imath::half& operator=(const ::Imath_3_0::half& h) CPPMM_RENAME(assign);
-    ::Imath::half& operator=(::Imath_3_0::half&& h) noexcept CPPMM_IGNORE;
+    ::Imath::half& operator=(::Imath_3_0::half&& h) noexcept;
     ::Imath::half& operator=(float f) CPPMM_IGNORE;
     ::Imath::half& operator+=(::Imath_3_0::half h) CPPMM_RENAME(add_assign);
     ::Imath::half& operator+=(float f) CPPMM_RENAME(add_assign_float);
@@ -46,7 +47,7 @@ class half {
     static ::Imath::half qNan();
     static ::Imath::half sNan();
 
-    unsigned short bits() const;
+    unsigned short bits() const CPPMM_BATCH;
     void setBits(unsigned short bits);
 } CPPMM_OPAQUEBYTES;
 } // namespace Imath
@@ -1,6 +1,7 @@
 //
 #include "half.h"
 #include <Imath/half.h>
+#include <algorithm>
 
 namespace {
 #include "casts.h"
@@ -65,6 +66,12 @@ void Imath_3_0_half_copy(Imath_3_0_half* self, const Imath_3_0_half* other) {
 
 
 
+void Imath_3_0_half_move_from(Imath_3_0_half* self, Imath_3_0_half* other) {
+    self = to_c(new (self) Imath_3_0::half(std::move(*to_cpp(other))));
+}
+
+
+
 void Imath_3_0_half_dtor(Imath_3_0_half* self) {
     to_cpp(self)->~half();
 }
@@ -101,6 +108,15 @@ unsigned short Imath_3_0_half_bits(const Imath_3_0_half* self) {
 
 
 
+
+void Imath_3_0_half_bits_batch(const Imath_3_0_half* self, unsigned short* _result, size_t _count) {
+    for (size_t _i = 0; _i < _count; ++_i) {
+        _result[_i] = to_cpp(self + _i)->bits();
+    }
+}
+
+
+
 bool Imath_3_0_half_isNegative(const Imath_3_0_half* self) {
     return to_cpp(self)->isNegative();
 }
@@ -120,6 +136,13 @@ Imath_3_0_half* Imath_3_0_half_assign(Imath_3_0_half* self, const Imath_3_0_half
 
 
 
+Imath_3_0_half* Imath_3_0_half_move_assign(Imath_3_0_half* self, Imath_3_0_half* other) {
+    *to_cpp(self) = std::move(*to_cpp(other));
+    return self;
+}
+
+
+
 Imath_3_0_half* Imath_3_0_half_mul_assign_float(Imath_3_0_half* self, float f) {
     *to_cpp(self) *= f;
     return self;
@@ -152,6 +175,15 @@ float Imath_3_0_half_to_float(const Imath_3_0_half* self) {
 
 
 
+
+void Imath_3_0_half_to_float_batch(const Imath_3_0_half* self, float* _result, size_t _count) {
+    for (size_t _i = 0; _i < _count; ++_i) {
+        _result[_i] = to_cpp(self + _i)->operator float();
+    }
+}
+
+
+
 void Imath_3_0_half_ctor(Imath_3_0_half* self) {
     self = to_c(new (self) Imath_3_0::half());
 }
@@ -191,6 +223,15 @@ void Imath_3_0_half_from_float(Imath_3_0_half* self, float f) {
 
 
 
+
+void Imath_3_0_half_from_float_batch(Imath_3_0_half* self, const float* f, size_t _count) {
+    for (size_t _i = 0; _i < _count; ++_i) {
+        new (self + _i) Imath_3_0::half(f[_i]);
+    }
+}
+
+
+
 Imath_3_0_half* Imath_3_0_half_mul_assign(Imath_3_0_half* self, Imath_3_0_half h) {
     *to_cpp(self) *= bit_cast<Imath_3_0::half>(h);
     return self;
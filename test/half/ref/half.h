@@ -39,6 +39,9 @@ bool Imath_3_0_half_isNormalized(const Imath_3_0_half* self);
 void Imath_3_0_half_copy(Imath_3_0_half* self, const Imath_3_0_half* other);
 
 
+void Imath_3_0_half_move_from(Imath_3_0_half* self, Imath_3_0_half* other);
+
+
 void Imath_3_0_half_dtor(Imath_3_0_half* self);
 
 
@@ -52,6 +55,7 @@ Imath_3_0_half Imath_3_0_half_round(const Imath_3_0_half* self, unsigned int n);
 
 
 unsigned short Imath_3_0_half_bits(const Imath_3_0_half* self);
+void Imath_3_0_half_bits_batch(const Imath_3_0_half* self, unsigned short* _result, size_t _count);
 
 
 bool Imath_3_0_half_isNegative(const Imath_3_0_half* self);
@@ -63,6 +67,9 @@ bool Imath_3_0_half_isInfinity(const Imath_3_0_half* self);
 Imath_3_0_half* Imath_3_0_half_assign(Imath_3_0_half* self, const Imath_3_0_half* other);
 
 
+Imath_3_0_half* Imath_3_0_half_move_assign(Imath_3_0_half* self, Imath_3_0_half* other);
+
+
 Imath_3_0_half* Imath_3_0_half_mul_assign_float(Imath_3_0_half* self, float f);
 
 
@@ -76,6 +83,7 @@ bool Imath_3_0_half_isZero(const Imath_3_0_half* self);
 
 
 float Imath_3_0_half_to_float(const Imath_3_0_half* self);
+void Imath_3_0_half_to_float_batch(const Imath_3_0_half* self, float* _result, size_t _count);
 
 
 void Imath_3_0_half_ctor(Imath_3_0_half* self);
@@ -94,6 +102,7 @@ Imath_3_0_half* Imath_3_0_half_sub_assign(Imath_3_0_half* self, Imath_3_0_half h
 
 
 void Imath_3_0_half_from_float(Imath_3_0_half* self, float f);
+void Imath_3_0_half_from_float_batch(Imath_3_0_half* self, const float* f, size_t _count);
 
 
 Imath_3_0_half* Imath_3_0_half_mul_assign(Imath_3_0_half* self, Imath_3_0_half h);
@@ -47,6 +47,7 @@ public:
 
 class IOMemReader {
     IOMemReader(void* buf, size_t size) CPPMM_RENAME(new);
+    IOMemReader(::OIIO::cspan<unsigned char> buf) CPPMM_RENAME(from_span);
     virtual ~IOMemReader() CPPMM_RENAME(delete);
     virtual const char* proxytype () const;
     virtual void close ();
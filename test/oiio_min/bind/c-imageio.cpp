@@ -50,9 +50,9 @@ class ImageSpec {
     ::OIIO::ImageSpec& operator=(const ::OIIO::ImageSpec& other)
         CPPMM_RENAME(assign);
 
-    ImageSpec(::OIIO::ImageSpec&& other) CPPMM_IGNORE;
+    ImageSpec(::OIIO::ImageSpec&& other);
 
-    ::OIIO::ImageSpec& operator=(::OIIO::ImageSpec&& other) CPPMM_IGNORE;
+    ::OIIO::ImageSpec& operator=(::OIIO::ImageSpec&& other);
 
     void set_format(::OIIO::TypeDesc fmt) noexcept;
 
@@ -99,11 +99,15 @@ class ImageInput {
     // create(::OIIO::string_view, bool, const ::OIIO::ImageSpec*,
     //        ::OIIO::Filesystem::IOProxy*, ::OIIO::string_view);
 
-    // bool read_image(int subimage, int miplevel, int chbegin, int chend,
-    //                 ::OIIO::TypeDesc format, void* data, stride_t xstride,
-    //                 stride_t ystride, stride_t zstride,
-    //                 ProgressCallback progress_callback,
-    //                 void* progress_callback_data);
+    bool read_image(int subimage, int miplevel, int chbegin, int chend,
+                    ::OIIO::TypeDesc format, void* data, stride_t xstride,
+                    stride_t ystride, stride_t zstride,
+                    ProgressCallback progress_callback,
+                    void* progress_callback_data);
+
+    bool read_scanlines(int subimage, int miplevel, int ybegin, int yend, int z,
+                        int chbegin, int chend, ::OIIO::TypeDesc format,
+                        void* data, stride_t xstride, stride_t ystride);
 
     std::string geterror() const;
 } CPPMM_OPAQUEPTR;
@@ -1,6 +1,7 @@
 //
 #include "c-filesystem.h"
 #include <OpenImageIO/filesystem.h>
+#include <algorithm>
 
 namespace {
 #include "casts.h"
@@ -13,6 +14,40 @@ CPPMM_DEFINE_POINTER_CASTS(OIIO::Filesystem::IOProxy, OIIO_Filesystem_IOProxy)
 
 extern "C" {
 
+size_t OIIO_Filesystem_IOMemReader_sizeof() {
+    return sizeof(OIIO::Filesystem::IOMemReader);
+}
+
+size_t OIIO_Filesystem_IOMemReader_alignof() {
+    return alignof(OIIO::Filesystem::IOMemReader);
+}
+
+void OIIO_Filesystem_IOMemReader_destruct_at(OIIO_Filesystem_IOMemReader* self) {
+    using T = OIIO::Filesystem::IOMemReader;
+    to_cpp(self)->~T();
+}
+
+void OIIO_Filesystem_IOMemReader_destroy(OIIO_Filesystem_IOMemReader* self) {
+    using T = OIIO::Filesystem::IOMemReader;
+    to_cpp(self)->~T();
+    cppmm_deallocate(self, sizeof(T), alignof(T));
+}
+
+
+size_t OIIO_Filesystem_IOProxy_sizeof() {
+    return sizeof(OIIO::Filesystem::IOProxy);
+}
+
+size_t OIIO_Filesystem_IOProxy_alignof() {
+    return alignof(OIIO::Filesystem::IOProxy);
+}
+
+void OIIO_Filesystem_IOProxy_destruct_at(OIIO_Filesystem_IOProxy* self) {
+    using T = OIIO::Filesystem::IOProxy;
+    to_cpp(self)->~T();
+}
+
+
 int OIIO_Filesystem_replace_extension(const char* filepath, const char* new_extension, char* _result_buffer_ptr, int _result_buffer_len) {
     const std::string result = OIIO::Filesystem::replace_extension(filepath, new_extension);
     safe_strcpy(_result_buffer_ptr, result, _result_buffer_len);
@@ -64,7 +99,27 @@ unsigned long OIIO_Filesystem_IOMemReader_read(OIIO_Filesystem_IOMemReader* self
 
 
 OIIO_Filesystem_IOMemReader* OIIO_Filesystem_IOMemReader_new(void* buf, unsigned long size) {
-    return to_c(new OIIO::Filesystem::IOMemReader(buf, size));
+    void* storage = cppmm_allocate(sizeof(OIIO::Filesystem::IOMemReader), alignof(OIIO::Filesystem::IOMemReader));
+    return to_c(new (storage) OIIO::Filesystem::IOMemReader(buf, size));
+}
+
+
+
+OIIO_Filesystem_IOMemReader* OIIO_Filesystem_IOMemReader_new_at(void* storage, void* buf, unsigned long size) {
+    return to_c(new (storage) OIIO::Filesystem::IOMemReader(buf, size));
+}
+
+
+
+OIIO_Filesystem_IOMemReader* OIIO_Filesystem_IOMemReader_from_span(const unsigned char* buf, size_t buf_len) {
+    void* storage = cppmm_allocate(sizeof(OIIO::Filesystem::IOMemReader), alignof(OIIO::Filesystem::IOMemReader));
+    return to_c(new (storage) OIIO::Filesystem::IOMemReader(OIIO::span<const unsigned char>(buf, buf_len)));
+}
+
+
+
+OIIO_Filesystem_IOMemReader* OIIO_Filesystem_IOMemReader_from_span_at(void* storage, const unsigned char* buf, size_t buf_len) {
+    return to_c(new (storage) OIIO::Filesystem::IOMemReader(OIIO::span<const unsigned char>(buf, buf_len)));
 }
 
 
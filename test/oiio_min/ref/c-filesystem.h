@@ -17,8 +17,17 @@ extern "C" {
 
 typedef struct OIIO_Filesystem_IOMemReader OIIO_Filesystem_IOMemReader;
 
+size_t OIIO_Filesystem_IOMemReader_sizeof();
+size_t OIIO_Filesystem_IOMemReader_alignof();
+void OIIO_Filesystem_IOMemReader_destruct_at(OIIO_Filesystem_IOMemReader* self);
+void OIIO_Filesystem_IOMemReader_destroy(OIIO_Filesystem_IOMemReader* self);
+
 typedef struct OIIO_Filesystem_IOProxy OIIO_Filesystem_IOProxy;
 
+size_t OIIO_Filesystem_IOProxy_sizeof();
+size_t OIIO_Filesystem_IOProxy_alignof();
+void OIIO_Filesystem_IOProxy_destruct_at(OIIO_Filesystem_IOProxy* self);
+
 enum OIIO_Filesystem_IOProxy_Mode {
     OIIO_Filesystem_IOProxy_Mode_Closed = 0,
     OIIO_Filesystem_IOProxy_Mode_Read = 114,
@@ -55,6 +64,11 @@ unsigned long OIIO_Filesystem_IOMemReader_read(OIIO_Filesystem_IOMemReader* self
 
 
 OIIO_Filesystem_IOMemReader* OIIO_Filesystem_IOMemReader_new(void* buf, unsigned long size);
+OIIO_Filesystem_IOMemReader* OIIO_Filesystem_IOMemReader_new_at(void* storage, void* buf, unsigned long size);
+
+
+OIIO_Filesystem_IOMemReader* OIIO_Filesystem_IOMemReader_from_span(const unsigned char* buf, size_t buf_len);
+OIIO_Filesystem_IOMemReader* OIIO_Filesystem_IOMemReader_from_span_at(void* storage, const unsigned char* buf, size_t buf_len);
 
 
 bool OIIO_Filesystem_IOMemReader_seek(OIIO_Filesystem_IOMemReader* self, long offset);
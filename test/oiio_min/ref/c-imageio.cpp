@@ -2,6 +2,7 @@
 #include "c-imageio.h"
 #include <OpenImageIO/filesystem.h>
 #include <OpenImageIO/imageio.h>
+#include <algorithm>
 
 namespace {
 #include "casts.h"
@@ -17,6 +18,24 @@ CPPMM_DEFINE_POINTER_CASTS(std::vector<OIIO::TypeDesc>, OIIO_TypeDesc_vector);
 }
 
 extern "C" {
+
+size_t OIIO_ImageInput_sizeof() {
+    return sizeof(OIIO::ImageInput);
+}
+
+size_t OIIO_ImageInput_alignof() {
+    return alignof(OIIO::ImageInput);
+}
+
+void OIIO_ImageInput_destruct_at(OIIO_ImageInput* self) {
+    using T = OIIO::ImageInput;
+    to_cpp(self)->~T();
+}
+
+void OIIO_ImageInput_free(OIIO_ImageInput* self) {
+    delete to_cpp(self);
+}
+
 static_assert(sizeof(OIIO::ROI) == sizeof(OIIO_ROI), "sizes do not match");
 static_assert(alignof(OIIO::ROI) == alignof(OIIO_ROI), "alignments do not match");
 static_assert(offsetof(OIIO::ROI, xbegin) == offsetof(OIIO_ROI, xbegin), "field offset does not match");
@@ -29,6 +48,26 @@ static_assert(offsetof(OIIO::ROI, chbegin) == offsetof(OIIO_ROI, chbegin), "fiel
 static_assert(offsetof(OIIO::ROI, chend) == offsetof(OIIO_ROI, chend), "field offset does not match");
 
 
+size_t OIIO_ImageSpec_sizeof() {
+    return sizeof(OIIO::ImageSpec);
+}
+
+size_t OIIO_ImageSpec_alignof() {
+    return alignof(OIIO::ImageSpec);
+}
+
+void OIIO_ImageSpec_destruct_at(OIIO_ImageSpec* self) {
+    using T = OIIO::ImageSpec;
+    to_cpp(self)->~T();
+}
+
+void OIIO_ImageSpec_destroy(OIIO_ImageSpec* self) {
+    using T = OIIO::ImageSpec;
+    to_cpp(self)->~T();
+    cppmm_deallocate(self, sizeof(T), alignof(T));
+}
+
+
 bool OIIO_getattribute(const char* name, OIIO_TypeDesc type, void* val) {
     return OIIO::getattribute(name, bit_cast<OIIO::TypeDesc>(type), val);
 }
@@ -61,12 +100,24 @@ OIIO_ImageInput* OIIO_ImageInput_open(const char* filename, const OIIO_ImageSpec
 
 
 
+bool OIIO_ImageInput_read_scanlines(OIIO_ImageInput* self, int subimage, int miplevel, int ybegin, int yend, int z, int chbegin, int chend, OIIO_TypeDesc format, void* data, long xstride, long ystride) {
+    return to_cpp(self)->read_scanlines(subimage, miplevel, ybegin, yend, z, chbegin, chend, bit_cast<OIIO::TypeDesc>(format), data, xstride, ystride);
+}
+
+
+
 const char* OIIO_ImageInput_format_name(const OIIO_ImageInput* self) {
     return to_cpp(self)->format_name();
 }
 
 
 
+bool OIIO_ImageInput_read_image(OIIO_ImageInput* self, int subimage, int miplevel, int chbegin, int chend, OIIO_TypeDesc format, void* data, long xstride, long ystride, long zstride, OIIO_ProgressCallback progress_callback, void* progress_callback_data) {
+    return to_cpp(self)->read_image(subimage, miplevel, chbegin, chend, bit_cast<OIIO::TypeDesc>(format), data, xstride, ystride, zstride, reinterpret_cast<bool (*)(void*, float)>(progress_callback), progress_callback_data);
+}
+
+
+
 OIIO_ROI OIIO_ROI_All() {
     return bit_cast<OIIO_ROI>(OIIO::ROI::All());
 }
@@ -122,7 +173,27 @@ void OIIO_ImageSpec_get_channelformats(const OIIO_ImageSpec* self, OIIO_TypeDesc
 
 
 OIIO_ImageSpec* OIIO_ImageSpec_copy(const OIIO_ImageSpec* other) {
-    return to_c(new OIIO::ImageSpec(*to_cpp(other)));
+    void* storage = cppmm_allocate(sizeof(OIIO::ImageSpec), alignof(OIIO::ImageSpec));
+    return to_c(new (storage) OIIO::ImageSpec(*to_cpp(other)));
+}
+
+
+
+OIIO_ImageSpec* OIIO_ImageSpec_copy_at(void* storage, const OIIO_ImageSpec* other) {
+    return to_c(new (storage) OIIO::ImageSpec(*to_cpp(other)));
+}
+
+
+
+OIIO_ImageSpec* OIIO_ImageSpec_move_from(OIIO_ImageSpec* other) {
+    void* storage = cppmm_allocate(sizeof(OIIO::ImageSpec), alignof(OIIO::ImageSpec));
+    return to_c(new (storage) OIIO::ImageSpec(std::move(*to_cpp(other))));
+}
+
+
+
+OIIO_ImageSpec* OIIO_ImageSpec_move_from_at(void* storage, OIIO_ImageSpec* other) {
+    return to_c(new (storage) OIIO::ImageSpec(std::move(*to_cpp(other))));
 }
 
 
@@ -142,7 +213,14 @@ void OIIO_ImageSpec_auto_stride(long* xstride, long* ystride, long* zstride, lon
 
 
 OIIO_ImageSpec* OIIO_ImageSpec_new_with_dimensions(int xres, int yres, int nchans, OIIO_TypeDesc fmt) {
-    return to_c(new OIIO::ImageSpec(xres, yres, nchans, bit_cast<OIIO::TypeDesc>(fmt)));
+    void* storage = cppmm_allocate(sizeof(OIIO::ImageSpec), alignof(OIIO::ImageSpec));
+    return to_c(new (storage) OIIO::ImageSpec(xres, yres, nchans, bit_cast<OIIO::TypeDesc>(fmt)));
+}
+
+
+
+OIIO_ImageSpec* OIIO_ImageSpec_new_with_dimensions_at(void* storage, int xres, int yres, int nchans, OIIO_TypeDesc fmt) {
+    return to_c(new (storage) OIIO::ImageSpec(xres, yres, nchans, bit_cast<OIIO::TypeDesc>(fmt)));
 }
 
 
@@ -160,7 +238,14 @@ unsigned long OIIO_ImageSpec_scanline_bytes(const OIIO_ImageSpec* self, bool nat
 
 
 OIIO_ImageSpec* OIIO_ImageSpec_new(OIIO_TypeDesc format) {
-    return to_c(new OIIO::ImageSpec(bit_cast<OIIO::TypeDesc>(format)));
+    void* storage = cppmm_allocate(sizeof(OIIO::ImageSpec), alignof(OIIO::ImageSpec));
+    return to_c(new (storage) OIIO::ImageSpec(bit_cast<OIIO::TypeDesc>(format)));
+}
+
+
+
+OIIO_ImageSpec* OIIO_ImageSpec_new_at(void* storage, OIIO_TypeDesc format) {
+    return to_c(new (storage) OIIO::ImageSpec(bit_cast<OIIO::TypeDesc>(format)));
 }
 
 
@@ -178,6 +263,13 @@ OIIO_ImageSpec* OIIO_ImageSpec_assign(OIIO_ImageSpec* self, const OIIO_ImageSpec
 
 
 
+OIIO_ImageSpec* OIIO_ImageSpec_move_assign(OIIO_ImageSpec* self, OIIO_ImageSpec* other) {
+    *to_cpp(self) = std::move(*to_cpp(other));
+    return self;
+}
+
+
+
 void OIIO_ImageSpec_set_format(OIIO_ImageSpec* self, OIIO_TypeDesc fmt) {
     to_cpp(self)->set_format(bit_cast<OIIO::TypeDesc>(fmt));
 }
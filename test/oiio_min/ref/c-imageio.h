@@ -19,6 +19,11 @@ extern "C" {
 
 typedef struct OIIO_ImageInput OIIO_ImageInput;
 
+size_t OIIO_ImageInput_sizeof();
+size_t OIIO_ImageInput_alignof();
+void OIIO_ImageInput_destruct_at(OIIO_ImageInput* self);
+void OIIO_ImageInput_free(OIIO_ImageInput* self);
+
 typedef struct {
     int xbegin;
     int xend;
@@ -32,6 +37,11 @@ typedef struct {
 
 typedef struct OIIO_ImageSpec OIIO_ImageSpec;
 
+size_t OIIO_ImageSpec_sizeof();
+size_t OIIO_ImageSpec_alignof();
+void OIIO_ImageSpec_destruct_at(OIIO_ImageSpec* self);
+void OIIO_ImageSpec_destroy(OIIO_ImageSpec* self);
+
 enum OIIO_ImageSpec_SerialVerbose {
     OIIO_ImageSpec_SerialVerbose_SerialBrief = 0,
     OIIO_ImageSpec_SerialVerbose_SerialDetailed = 1,
@@ -163,9 +173,64 @@ int OIIO_ImageInput_geterror(const OIIO_ImageInput* self, char* _result_buffer_p
 ///         required writer was not able to be created.
 OIIO_ImageInput* OIIO_ImageInput_open(const char* filename, const OIIO_ImageSpec* config, OIIO_Filesystem_IOProxy* ioproxy);
 
+/// Read multiple scanlines that include pixels (*,y,z) for all ybegin
+/// <= y < yend in the specified subimage and mip level, into `data`,
+/// using the strides given and converting to the requested data
+/// `format` (TypeUnknown indicates no conversion, just copy native data
+/// types). Only channels [chbegin,chend) will be read/copied
+/// (chbegin=0, chend=spec.nchannels reads all channels, yielding
+/// equivalent behavior to the simpler variant of `read_scanlines`).
+///
+/// This version of read_scanlines, because it passes explicit
+/// subimage/miplevel, does not require a separate call to
+/// seek_subimage, and is guaranteed to be thread-safe against other
+/// concurrent calls to any of the read_* methods that take an explicit
+/// subimage/miplevel (but not against any other ImageInput methods).
+///
+/// @param  subimage    The subimage to read from (starting with 0).
+/// @param  miplevel    The MIP level to read (0 is the highest
+///                     resolution level).
+/// @param  ybegin/yend The y range of the scanlines being passed.
+/// @param  z           The z coordinate of the scanline.
+/// @param  chbegin/chend
+///                     The channel range to read.
+/// @param  format      A TypeDesc describing the type of `data`.
+/// @param  data        Pointer to the pixel data.
+/// @param  xstride/ystride
+///                     The distance in bytes between successive
+///                     pixels and scanlines (or `AutoStride`).
+/// @returns            `true` upon success, or `false` upon failure.
+bool OIIO_ImageInput_read_scanlines(OIIO_ImageInput* self, int subimage, int miplevel, int ybegin, int yend, int z, int chbegin, int chend, OIIO_TypeDesc format, void* data, long xstride, long ystride);
+
 /// Return the name of the format implemented by this class.
 const char* OIIO_ImageInput_format_name(const OIIO_ImageInput* self);
 
+#ifndef CPPMM_CALLBACK_OIIO_ProgressCallback
+#define CPPMM_CALLBACK_OIIO_ProgressCallback
+typedef bool (*OIIO_ProgressCallback)(void*, float);
+#endif
+/// Read the entire image of `spec.width x spec.height x spec.depth`
+/// pixels into a buffer with the given strides and in the desired
+/// data format.
+///
+/// Depending on the spec, this will read either all tiles or all
+/// scanlines. Assume that data points to a layout in row-major order.
+///
+/// This version of read_image, because it passes explicit subimage and
+/// miplevel, does not require a separate call to seek_subimage, and is
+/// guaranteed to be thread-safe against other concurrent calls to any
+/// of the read_* methods that take an explicit subimage/miplevel (but
+/// not against any other ImageInput methods).
+///
+/// Because this may be an expensive operation, a progress callback
+/// may be passed.  Periodically, it will be called as follows:
+///
+///     progress_callback (progress_callback_data, float done);
+///
+/// where `done` gives the portion of the image (between 0.0 and 1.0)
+/// that has been read thus far.
+bool OIIO_ImageInput_read_image(OIIO_ImageInput* self, int subimage, int miplevel, int chbegin, int chend, OIIO_TypeDesc format, void* data, long xstride, long ystride, long zstride, OIIO_ProgressCallback progress_callback, void* progress_callback_data);
+
 /// All() is an alias for the default constructor, which indicates that
 /// it means "all" of the image, or no region restriction.  For example,
 ///     float myfunc (ImageBuf &buf, ROI roi = ROI::All());
@@ -207,6 +272,11 @@ void OIIO_ImageSpec_get_channelformats(const OIIO_ImageSpec* self, OIIO_TypeDesc
 
 
 OIIO_ImageSpec* OIIO_ImageSpec_copy(const OIIO_ImageSpec* other);
+OIIO_ImageSpec* OIIO_ImageSpec_copy_at(void* storage, const OIIO_ImageSpec* other);
+
+
+OIIO_ImageSpec* OIIO_ImageSpec_move_from(OIIO_ImageSpec* other);
+OIIO_ImageSpec* OIIO_ImageSpec_move_from_at(void* storage, OIIO_ImageSpec* other);
 
 /// Returns, as a string, a serialized version of the `ImageSpec`. The
 /// `format` may be either `ImageSpec::SerialText` or
@@ -233,6 +303,7 @@ void OIIO_ImageSpec_auto_stride(long* xstride, long* ystride, long* zstride, lon
 /// channels, beyond that they are named "channel *n*"), the fourth
 /// channel (if it exists) is assumed to be alpha.
 OIIO_ImageSpec* OIIO_ImageSpec_new_with_dimensions(int xres, int yres, int nchans, OIIO_TypeDesc fmt);
+OIIO_ImageSpec* OIIO_ImageSpec_new_with_dimensions_at(void* storage, int xres, int yres, int nchans, OIIO_TypeDesc fmt);
 
 /// Returns the number of bytes comprising each channel of each pixel
 /// (i.e., the size of a single value of the type described by the
@@ -248,6 +319,7 @@ unsigned long OIIO_ImageSpec_scanline_bytes(const OIIO_ImageSpec* self, bool nat
 /// Constructor: given just the data format, set all other fields to
 /// something reasonable.
 OIIO_ImageSpec* OIIO_ImageSpec_new(OIIO_TypeDesc format);
+OIIO_ImageSpec* OIIO_ImageSpec_new_at(void* storage, OIIO_TypeDesc format);
 
 /// Sets the `channelnames` to reasonable defaults for the number of
 /// channels.  Specifically, channel names are set to "R", "G", "B,"
@@ -258,6 +330,9 @@ void OIIO_ImageSpec_default_channel_names(OIIO_ImageSpec* self);
 
 OIIO_ImageSpec* OIIO_ImageSpec_assign(OIIO_ImageSpec* self, const OIIO_ImageSpec* other);
 
+
+OIIO_ImageSpec* OIIO_ImageSpec_move_assign(OIIO_ImageSpec* self, OIIO_ImageSpec* other);
+
 /// Set the data format, and clear any per-channel format information
 /// in `channelformats`.
 void OIIO_ImageSpec_set_format(OIIO_ImageSpec* self, OIIO_TypeDesc fmt);
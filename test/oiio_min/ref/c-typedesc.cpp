@@ -1,6 +1,7 @@
 //
 #include "c-typedesc.h"
 #include <OpenImageIO/typedesc.h>
+#include <algorithm>
 
 namespace {
 #include "casts.h"
@@ -38,6 +39,41 @@ void OIIO_TypeDesc_vector_get(const OIIO_TypeDesc_vector* vec, int index, OIIO_T
 void OIIO_TypeDesc_vector_set(OIIO_TypeDesc_vector* vec, int index, OIIO_TypeDesc* element) {
     (*to_cpp(vec))[index] = *to_cpp(element);
 }
+
+void OIIO_TypeDesc_vector_reserve(OIIO_TypeDesc_vector* vec, size_t n) {
+    to_cpp(vec)->reserve(n);
+}
+
+void OIIO_TypeDesc_vector_resize(OIIO_TypeDesc_vector* vec, size_t n) {
+    to_cpp(vec)->resize(n);
+}
+
+void OIIO_TypeDesc_vector_clear(OIIO_TypeDesc_vector* vec) {
+    to_cpp(vec)->clear();
+}
+
+void OIIO_TypeDesc_vector_push_back(OIIO_TypeDesc_vector* vec, const OIIO_TypeDesc* element) {
+    to_cpp(vec)->push_back(*to_cpp(element));
+}
+
+size_t OIIO_TypeDesc_vector_copy_to(const OIIO_TypeDesc_vector* vec, OIIO_TypeDesc* dst, size_t n) {
+    const std::vector<OIIO::TypeDesc>& v = *to_cpp(vec);
+    const size_t count = std::min(n, v.size());
+    memcpy((void*)dst, (const void*)v.data(), count * sizeof(OIIO::TypeDesc));
+    return count;
+}
+
+void OIIO_TypeDesc_vector_copy_from(OIIO_TypeDesc_vector* vec, const OIIO_TypeDesc* src, size_t n) {
+    to_cpp(vec)->assign(to_cpp(src), to_cpp(src) + n);
+}
+
+void OIIO_TypeDesc_vector_assign_range(OIIO_TypeDesc_vector* vec, size_t offset, const OIIO_TypeDesc* src, size_t n) {
+    std::vector<OIIO::TypeDesc>& v = *to_cpp(vec);
+    if (v.size() < offset + n) {
+        v.resize(offset + n);
+    }
+    memcpy((void*)(v.data() + offset), (const void*)src, n * sizeof(OIIO::TypeDesc));
+}
 static_assert(sizeof(OIIO::TypeDesc) == sizeof(OIIO_TypeDesc), "sizes do not match");
 static_assert(alignof(OIIO::TypeDesc) == alignof(OIIO_TypeDesc), "alignments do not match");
 static_assert(offsetof(OIIO::TypeDesc, basetype) == offsetof(OIIO_TypeDesc, basetype), "field offset does not match");
@@ -33,6 +33,14 @@ OIIO_TypeDesc* OIIO_TypeDesc_vector_data(OIIO_TypeDesc_vector* vec);
 
 void OIIO_TypeDesc_vector_get(const OIIO_TypeDesc_vector* vec, int index, OIIO_TypeDesc* element);
 void OIIO_TypeDesc_vector_set(OIIO_TypeDesc_vector* vec, int index, OIIO_TypeDesc* element);
+
+void OIIO_TypeDesc_vector_reserve(OIIO_TypeDesc_vector* vec, size_t n);
+void OIIO_TypeDesc_vector_resize(OIIO_TypeDesc_vector* vec, size_t n);
+void OIIO_TypeDesc_vector_clear(OIIO_TypeDesc_vector* vec);
+void OIIO_TypeDesc_vector_push_back(OIIO_TypeDesc_vector* vec, const OIIO_TypeDesc* element);
+size_t OIIO_TypeDesc_vector_copy_to(const OIIO_TypeDesc_vector* vec, OIIO_TypeDesc* dst, size_t n);
+void OIIO_TypeDesc_vector_copy_from(OIIO_TypeDesc_vector* vec, const OIIO_TypeDesc* src, size_t n);
+void OIIO_TypeDesc_vector_assign_range(OIIO_TypeDesc_vector* vec, size_t offset, const OIIO_TypeDesc* src, size_t n);
 enum OIIO_TypeDesc_VECSEMANTICS {
     OIIO_TypeDesc_VECSEMANTICS_NOXFORM = 0,
     OIIO_TypeDesc_VECSEMANTICS_NOSEMANTICS = 0,
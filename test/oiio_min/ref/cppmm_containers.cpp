@@ -1,5 +1,7 @@
 
 #include "cppmm_containers.h"
+#include <algorithm>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -7,13 +9,52 @@ namespace {
 #include "casts.h"
 
 CPPMM_DEFINE_POINTER_CASTS(std::vector<std::string>, cppmm_string_vector);
+CPPMM_DEFINE_POINTER_CASTS(std::string, cppmm_string);
 
+// cppmm_string is sized to hold std::string from both libstdc++ and libc++
+static_assert(sizeof(std::string) <= sizeof(cppmm_string),
+              "cppmm_string is too small for std::string");
+static_assert(alignof(std::string) <= alignof(cppmm_string),
+              "cppmm_string is not aligned enough for std::string");
+
+// Over-aligned requests need the aligned operator new, which is only there
+// from C++17
+void* default_allocate(size_t size, size_t alignment, void* user_data) {
+#if __cpp_aligned_new
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+#endif
+    return ::operator new(size);
+}
+
+void default_deallocate(void* ptr, size_t size, size_t alignment, void* user_data) {
+#if __cpp_aligned_new
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        ::operator delete(ptr, std::align_val_t(alignment));
+        return;
+    }
+#endif
+    ::operator delete(ptr);
+}
+
+cppmm_allocate_fn allocate_fn = default_allocate;
+cppmm_deallocate_fn deallocate_fn = default_deallocate;
+void* allocator_user_data = nullptr;
 
 #undef CPPMM_DEFINE_POINTER_CASTS
 }
 
 extern "C" {
 
+void cppmm_string_vector_ctor(cppmm_string_vector* vec) {
+    new (vec) std::vector<std::string>();
+}
+
+void cppmm_string_vector_dtor(const cppmm_string_vector* vec) {
+    to_cpp(vec)->~vector();
+}
+
 const char* cppmm_string_vector_get(const cppmm_string_vector* vec, int index) {
     return (*to_cpp(vec))[index].c_str();
 }
@@ -22,5 +63,86 @@ int cppmm_string_vector_size(const cppmm_string_vector* vec) {
     return to_cpp(vec)->size();
 }
 
+void cppmm_string_vector_packed_size(const cppmm_string_vector* vec, size_t* bytes_len, size_t* offsets_len) {
+    const std::vector<std::string>& v = *to_cpp(vec);
+    size_t total = 0;
+    for (const auto& s : v) {
+        total += s.size();
+    }
+    *bytes_len = total;
+    *offsets_len = v.size() + 1;
+}
+
+bool cppmm_string_vector_export(const cppmm_string_vector* vec, char* bytes, size_t bytes_len, size_t* offsets, size_t offsets_len) {
+    const std::vector<std::string>& v = *to_cpp(vec);
+    if (offsets_len < v.size() + 1) {
+        return false;
+    }
+
+    size_t total = 0;
+    for (const auto& s : v) {
+        total += s.size();
+    }
+    if (bytes_len < total) {
+        return false;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < v.size(); ++i) {
+        offsets[i] = offset;
+        memcpy(bytes + offset, v[i].data(), v[i].size());
+        offset += v[i].size();
+    }
+    offsets[v.size()] = offset;
+    return true;
+}
+
+void cppmm_string_vector_import(cppmm_string_vector* vec, const char* bytes, const size_t* offsets, size_t count) {
+    std::vector<std::string>& v = *to_cpp(vec);
+    v.clear();
+    v.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        v.emplace_back(bytes + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+}
+
+void cppmm_string_dtor(cppmm_string* str) {
+    using std::string;
+    to_cpp(str)->~string();
+}
+
+const char* cppmm_string_c_str(const cppmm_string* str) {
+    return to_cpp(str)->c_str();
+}
+
+size_t cppmm_string_size(const cppmm_string* str) {
+    return to_cpp(str)->size();
+}
+
+cppmm_string_view cppmm_string_as_view(const cppmm_string* str) {
+    const std::string& s = *to_cpp(str);
+    return cppmm_string_view{s.data(), s.size()};
+}
+
+void cppmm_set_allocator(cppmm_allocate_fn allocate, cppmm_deallocate_fn deallocate, void* user_data) {
+    if (allocate == nullptr && deallocate == nullptr) {
+        allocate_fn = default_allocate;
+        deallocate_fn = default_deallocate;
+        allocator_user_data = nullptr;
+    } else {
+        allocate_fn = allocate;
+        deallocate_fn = deallocate;
+        allocator_user_data = user_data;
+    }
+}
+
+void* cppmm_allocate(size_t size, size_t alignment) {
+    return allocate_fn(size, alignment, allocator_user_data);
+}
+
+void cppmm_deallocate(void* ptr, size_t size, size_t alignment) {
+    deallocate_fn(ptr, size, alignment, allocator_user_data);
+}
+
 }
     
\ No newline at end of file
@@ -1,5 +1,7 @@
 
 #pragma once
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #else
@@ -15,9 +17,47 @@ extern "C" {
 
 typedef struct { char _private[24]; } cppmm_string_vector CPPMM_ALIGN(8);
 
+void cppmm_string_vector_ctor(cppmm_string_vector* vec);
+void cppmm_string_vector_dtor(const cppmm_string_vector* vec);
 const char* cppmm_string_vector_get(const cppmm_string_vector* vec, int index);
 int cppmm_string_vector_size(const cppmm_string_vector* vec);
 
+// Packed format for moving a whole vector of strings in one call: the strings
+// are concatenated without terminators into bytes, and string i is
+// bytes[offsets[i], offsets[i+1]), so offsets has one more entry than there are
+// strings.
+void cppmm_string_vector_packed_size(const cppmm_string_vector* vec, size_t* bytes_len, size_t* offsets_len);
+// Returns false, writing nothing, if either buffer is too small
+bool cppmm_string_vector_export(const cppmm_string_vector* vec, char* bytes, size_t bytes_len, size_t* offsets, size_t offsets_len);
+// Replaces the contents of vec with the count strings packed in bytes
+void cppmm_string_vector_import(cppmm_string_vector* vec, const char* bytes, const size_t* offsets, size_t count);
+
+// A borrowed, not necessarily NUL-terminated, string. Only valid for as long
+// as the object it was returned from.
+typedef struct {
+    const char* ptr;
+    size_t len;
+} cppmm_string_view;
+
+// An owned std::string that a function has moved its result into. Must be
+// destroyed with cppmm_string_dtor() and must not be copied bitwise.
+typedef struct { char _private[32]; } cppmm_string CPPMM_ALIGN(8);
+
+void cppmm_string_dtor(cppmm_string* str);
+const char* cppmm_string_c_str(const cppmm_string* str);
+size_t cppmm_string_size(const cppmm_string* str);
+cppmm_string_view cppmm_string_as_view(const cppmm_string* str);
+
+// Allocator used for every OpaquePtr object the library creates with a _new()
+// style constructor. Defaults to the global operator new/delete. Passing NULL
+// for both functions restores the default.
+typedef void* (*cppmm_allocate_fn)(size_t size, size_t alignment, void* user_data);
+typedef void (*cppmm_deallocate_fn)(void* ptr, size_t size, size_t alignment, void* user_data);
+
+void cppmm_set_allocator(cppmm_allocate_fn allocate, cppmm_deallocate_fn deallocate, void* user_data);
+void* cppmm_allocate(size_t size, size_t alignment);
+void cppmm_deallocate(void* ptr, size_t size, size_t alignment);
+
 
 #ifdef __cplusplus
 }